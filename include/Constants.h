@@ -10,14 +10,45 @@ const int SCREEN_HEIGHT = 750;
 
 // Giới hạn game
 const int MAX_OBSTACLES = 8;
+const int MAX_STRESS_OBSTACLES = 100000; // Giới hạn cho chế độ mật độ cao (--density)
 const int MAX_SPEED = 25;
+const int VICTORY_SCORE = 500;             // Điểm để thắng
+const float VICTORY_PREFETCH_FRACTION = 0.8f; // Tải trước tài nguyên VICTORY khi điểm đạt tỉ lệ này của VICTORY_SCORE
+const int INITIAL_SPEED_FACTOR = 2;      // Yếu tố tốc độ vật cản lúc bắt đầu ván
 const int OBSTACLE_SIZE = 40;
+const int COLLISION_CELL_SIZE = 64; // Kích thước ô của lưới broadphase
+const Uint8 COLLISION_ALPHA_THRESHOLD = 128; // Pixel có alpha từ mức này trở lên mới tính va chạm
+const int MASK_SWEEP_MAX_STEPS = 64;         // Số lần thử mặt nạ tối đa cho một đoạn quét
+const int CHARACTER_FRAME_COUNT = 3;         // Số frame trong sprite sheet nhân vật
 
-struct DialogueLine {
-    std::string speakerName; // Tên người nói (ví dụ: "Hero", "Sage", hoặc để trống)
-    std::string text;        // Nội dung lời thoại
-};
+// Mô phỏng chạy theo bước cố định, độc lập với tốc độ khung hình
+const int SIM_TICK_RATE = 60;                         // Số bước mô phỏng mỗi giây
+const float SIM_DT = 1.0f / SIM_TICK_RATE;            // Thời gian một bước (giây)
+const int MAX_SIM_STEPS_PER_FRAME = 5;                // Tránh "vòng xoáy" khi máy chậm: bỏ bớt thời gian thừa
+const Uint32 SIM_IDLE_SLEEP_MS = 5;                   // Luồng mô phỏng nghỉ bao lâu mỗi lần khi không chơi
+const Uint32 JOB_IDLE_WAIT_MS = 10;                   // Worker không có job ngủ tối đa bao lâu trước khi kiểm tra lại
+const size_t PARALLEL_OBSTACLE_GRAIN = 16384;         // Số vật cản mỗi job khi cập nhật song song
+
+const int ASSET_UPLOADS_PER_FRAME = 2;   // Số texture tối đa tạo mỗi khung hình trong lúc loading
+const int LOADING_BAR_WIDTH = 300;
+const int LOADING_BAR_HEIGHT = 20;
+
+const int DEFAULT_TEXTURE_BUDGET_MB = 64; // Ngân sách bộ nhớ texture của ResourceManager (--texture-budget)
+const char* const ASSET_PACK_PATH = "assets.pak"; // Tạo bằng make pack; không có thì đọc file rời
+const int SDF_BASE_SIZE = 48;            // Cỡ rasterize font một lần để dựng atlas SDF
+const char* const DEFAULT_LANGUAGE = "en";  // Chuỗi giao diện trong assets/strings/<ngôn ngữ>.txt (--lang)
+
+const int DEFAULT_TARGET_FPS = 60;       // Dùng khi không đọc được tần số quét màn hình
+const int FRAME_STATS_INTERVAL = 300;    // Số khung hình giữa hai lần in thống kê (--frame-stats)
+const Uint32 IDLE_WAIT_MS = 500;         // Màn hình tĩnh chờ sự kiện tối đa bao lâu trước khi kiểm tra lại
+const int CHARACTER_PREVIEW_FPS = 10;    // Nhịp animation xem trước nhân vật ở menu (bằng tốc độ đổi frame của sprite)
+
+const float DIALOGUE_CHARS_PER_SECOND = 40.0f; // Tốc độ hiện chữ của hội thoại
+const int DIALOGUE_NAME_GAP = 8;               // Khoảng cách giữa tên người nói và lời thoại
+
+const int UI_BUTTON_TEXT_OFFSET_X = -25;       // Chữ trên nút lệch trái so với tâm nút cho khớp ảnh nền
 enum class GameState { 
+    LOADING,
     MENU, 
     PLAYING, 
     GUIDE, 
@@ -26,4 +57,19 @@ enum class GameState {
     VICTORY
 };
 
+// Việc mà một widget yêu cầu khi được bấm
+enum class UiAction {
+    NONE,
+    PLAY,
+    GUIDE,
+    SETTINGS,
+    TOGGLE_MUSIC,
+    BACK,
+    CONTINUE,
+    RESTART,
+    MENU,
+    PREVIOUS_CHARACTER,
+    NEXT_CHARACTER
+};
+
 #endif // CONSTANTS_H
\ No newline at end of file
@@ -7,33 +7,91 @@
 #include <SDL.h>
 #include <SDL_mixer.h>
 #include "constants.h"
+#include "texture_atlas.h"
+#include "sprite_batch.h"
+#include "spatial_grid.h"
+#include "collision.h"
+#include "job_system.h"
 
-struct Obstacle {
-    SDL_Rect rect;
-    float speed;    
-    bool passed;
-    int textureIndex;
+const Uint8 OBSTACLE_PASSED = 1 << 0; // Vật cản đã đi qua đáy màn hình và đã được tính điểm
+
+// Kho vật cản dạng structure-of-arrays: mỗi thuộc tính nằm trong một mảng liên tục
+// để kernel cập nhật có thể xử lý nhiều vật cản cùng lúc bằng SIMD.
+struct ObstacleStore {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> prevY;   // y ở đầu lần update gần nhất (đoạn di chuyển của khung hình)
+    std::vector<float> speed;   // pixels/giây
+    std::vector<Uint8> flags;
+    std::vector<int> texture;   // Chỉ số ảnh vật cản
+
+    size_t size() const { return y.size(); }
+    bool empty() const { return y.empty(); }
+    void clear();
+    void reserve(size_t count);
+    void push(float px, float py, float pspeed, int ptexture);
+    SDL_Rect rect(size_t i) const;
 };
+
 class ObstacleManager {
 public:
     ObstacleManager();
     ~ObstacleManager();
 
-    void loadTextures(SDL_Renderer* renderer);
+    // Đường dẫn các ảnh vật cản, để tải trước
+    static std::vector<std::string> texturePaths();
+    // Đăng ký ảnh vật cản vào atlas (atlas sẽ được build sau đó)
+    void loadTextures(TextureAtlas& atlas);
+    // Tạo mặt nạ va chạm theo kích thước vẽ từ atlas đã build
+    void buildMasks(const TextureAtlas& atlas);
+    // Mặt nạ của ảnh vật cản thứ textureIndex, nullptr nếu chưa có
+    const CollisionMask* mask(int textureIndex) const;
     void update(float deltaTime, int& currentScore, Mix_Chunk* scoreSoundEffect);
-    void render(SDL_Renderer* renderer);
+    // Vẽ các vật cản trong `store` (thường là bản sao trong snapshot);
+    // alpha: nội suy giữa vị trí đầu và cuối của bước mô phỏng gần nhất (0..1)
+    void render(SpriteBatch& batch, const TextureAtlas& atlas, const ObstacleStore& store, float alpha) const;
+    // Sao chép vị trí và ảnh của vật cản ra `out` (không có speed/flags), giữ lại bộ nhớ của out
+    void copyState(ObstacleStore& out) const;
+    // Sinh trước trạng thái đầu ván (vật cản, lưới, bộ sinh số) từ seed và mật độ hiện tại.
+    // Không làm gì nếu đã có và seed, mật độ, ảnh vật cản không đổi. Không đụng tới ván đang chơi.
+    void prepareInitialState();
+    // Khôi phục trạng thái đầu ván đã sinh trước; chỉ sao chép vào bộ nhớ sẵn có, không cấp phát.
+    // Cùng seed và cùng input cho ra cùng một ván chơi; không có seed cố định thì mỗi ván một seed mới.
     void reset();
+    // Cố định seed cho mọi ván (--seed)
+    void setSeed(Uint32 seed);
 
-    const std::vector<Obstacle>& getObstacles() const;
+    const ObstacleStore& getObstacles() const;
+    // Thêm vào out chỉ số các vật cản có chung ô lưới với rect (broadphase, chưa lọc AABB).
+    // Chỉ phần nằm trong sân chơi mới được tính; nơi gọi tự kiểm tra va chạm chính xác.
+    void queryCandidates(const SDL_Rect& rect, std::vector<int>& out);
+    // Quãng đường lớn nhất một vật cản có thể đi trong deltaTime
+    float maxStep(float deltaTime) const;
 
     void setBaseSpeedFactor(int factor);
+    // Bộ lập lịch job dùng để cập nhật song song khi có nhiều vật cản (nullptr: chạy trên luồng gọi)
+    void setJobSystem(JobSystem* jobs);
+    // Số vật cản tối đa; lớn hơn MAX_OBSTACLES sẽ bật chế độ mật độ cao (stress)
+    void setDensity(int maxObstacles);
+    int getDensity() const;
 
 private:
     void spawnObstacles(int count);
-    std::vector<Obstacle> m_obstacles;
-    std::vector<SDL_Texture*> m_obstacleTextures;
-    SDL_Renderer* m_renderer; // Lưu con trỏ renderer để load textures
+    void spawnStress(int count);
+    void pushObstacle(float x, float y, float speed, int texture);
+    ObstacleStore m_obstacles;
+    SpatialGrid m_grid;       // Broadphase, cập nhật dần theo vị trí vật cản
+    std::vector<int> m_regionIds; // Id vùng của từng ảnh vật cản trong atlas
+    std::vector<CollisionMask> m_masks; // Cùng chỉ số với m_regionIds
     std::mt19937 m_rng;       // Bộ tạo số ngẫu nhiên riêng
+    Uint32 m_seed;
+    bool m_seedPinned;        // setSeed() đã được gọi: mọi ván dùng cùng m_seed
     int m_baseSpeedFactor;    // Yếu tố tốc độ cơ bản, được Game cập nhật
+    int m_maxObstacles;
+    JobSystem* m_jobs;
+    ObstacleStore m_initialObstacles; // Trạng thái đầu ván, reset() sao chép từ đây (chỉ dùng lại khi seed cố định)
+    SpatialGrid m_initialGrid;
+    std::mt19937 m_initialRng;
+    bool m_initialReady;
 };
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,80 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "job_system.h"
+#include "image_cache.h"
+
+const unsigned ASSET_SURFACE = 1 << 0; // Giữ lại surface đã giải mã (ví dụ để đóng gói atlas)
+const unsigned ASSET_TEXTURE = 1 << 1; // Tạo texture từ surface trên luồng vẽ
+
+// Tải tài nguyên bất đồng bộ: ảnh và âm thanh được giải mã song song trên các worker của JobSystem,
+// còn texture được tạo trên luồng vẽ qua pump(), mỗi khung hình một ít để màn hình loading không bị giật.
+// Loader giữ quyền sở hữu mọi tài nguyên cho tới khi được lấy ra bằng take*().
+class AssetLoader {
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    void setJobSystem(JobSystem* jobs);
+    // Ảnh được đọc qua bộ đệm ảnh đã giải mã nếu có (nullptr: luôn giải mã)
+    void setImageCache(ImageCache* cache);
+    // Tài nguyên có trong pack được đọc từ pack, còn lại từ file rời (nullptr: chỉ file rời)
+    void setAssetPack(const AssetPack* pack);
+    // Xếp hàng một ảnh, flags là tổ hợp ASSET_SURFACE / ASSET_TEXTURE; trả về id
+    int queueImage(const std::string& path, unsigned flags);
+    // Xếp hàng một âm thanh ngắn (Mix_Chunk); trả về id
+    int queueChunk(const std::string& path);
+    // Gửi job giải mã cho mọi thứ đã xếp hàng
+    void start();
+    // Luồng vẽ: tạo tối đa maxUploads texture từ các ảnh đã giải mã xong
+    void pump(SDL_Renderer* renderer, int maxUploads);
+    // Luồng vẽ: chờ mọi job giải mã rồi tạo hết texture còn lại (dùng khi không thể chờ thêm)
+    void finish(SDL_Renderer* renderer);
+
+    // Tỉ lệ tài nguyên đã xong (0..1), kể cả tài nguyên lỗi
+    float progress() const;
+    bool isDone() const;
+
+    const std::string& path(int id) const;
+    // Chuyển quyền sở hữu cho nơi gọi; nullptr nếu lỗi hoặc đã lấy
+    SDL_Surface* takeSurface(int id);
+    SDL_Texture* takeTexture(int id);
+    Mix_Chunk* takeChunk(int id);
+
+    // Chờ các job còn chạy rồi giải phóng những gì chưa được lấy; gọi trước SDL_DestroyRenderer
+    void release();
+
+private:
+    enum State { QUEUED, DECODED, READY };
+
+    struct Entry {
+        std::string path;
+        bool isSound;
+        unsigned flags;
+        SDL_Surface* surface;
+        SDL_Texture* texture;
+        Mix_Chunk* chunk;
+        std::atomic<int> state;
+    };
+
+    int queue(const std::string& path, bool isSound, unsigned flags);
+    void decode(Entry& entry);
+    void waitJobs();
+    SDL_RWops* openRW(const std::string& path) const;
+
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    std::vector<JobHandle> m_jobs;
+    JobSystem* m_jobSystem;
+    ImageCache* m_imageCache;
+    const AssetPack* m_pack;
+    std::atomic<int> m_readyCount;
+    bool m_started;
+};
+
+#endif
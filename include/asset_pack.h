@@ -0,0 +1,39 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <SDL.h>
+#include <string>
+#include <unordered_map>
+#include "mapped_file.h"
+
+// Một asset trong pack: dữ liệu nằm thẳng trong vùng nhớ đã ánh xạ
+struct PackedAsset {
+    const Uint8* data;
+    size_t size;
+    Sint64 mtime;   // mtime của file gốc lúc đóng gói
+};
+
+// Đọc file pack do công cụ pack_assets tạo ra (make pack).
+// Cả pack được ánh xạ một lần; mỗi asset được trả về dạng SDL_RWFromConstMem không sao chép.
+// Tra cứu không phân biệt hoa thường. Asset không có trong pack (hoặc không có pack) được đọc từ file rời.
+// Pack phải còn mở chừng nào còn tài nguyên đọc từ nó (font, nhạc đọc dần từ RWops).
+class AssetPack {
+public:
+    AssetPack();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+    size_t count() const;
+
+    // false nếu asset không có trong pack
+    bool find(const std::string& path, PackedAsset* out) const;
+    // RWops cho asset, đóng bằng SDL_RWclose hoặc truyền freesrc = 1 cho hàm tải của SDL
+    SDL_RWops* openRW(const std::string& path) const;
+
+private:
+    MappedFile m_file;
+    std::unordered_map<std::string, PackedAsset> m_index;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef BACKDROP_H
+#define BACKDROP_H
+
+#include <SDL.h>
+#include <functional>
+#include <vector>
+#include "constants.h"
+
+enum class BackdropStyle {
+    DIM,    // Chỉ phủ lớp tối
+    BLUR    // Làm mờ rồi phủ lớp tối
+};
+
+// Chụp lại khung hình gameplay cuối cùng vào một texture khi pause hoặc game over.
+// Lớp tối / làm mờ chỉ được tính một lần lúc chụp, các khung hình sau chỉ copy texture này.
+class FrozenBackdrop {
+public:
+    FrozenBackdrop();
+    ~FrozenBackdrop();
+
+    // Vẽ cảnh bằng drawScene vào texture rồi áp dụng style; trả về false nếu không có render target
+    bool capture(SDL_Renderer* renderer, const std::function<void(SDL_Renderer*)>& drawScene,
+                 BackdropStyle style, Uint8 dimAlpha);
+    void render(SDL_Renderer* renderer) const;
+    void invalidate();
+    bool isCaptured() const;
+    // Thêm các texture đang có vào out (để tính bộ nhớ texture)
+    void collectTextures(std::vector<SDL_Texture*>& out) const;
+    // Giải phóng texture, phải gọi trước SDL_DestroyRenderer
+    void release();
+
+private:
+    bool ensureTextures(SDL_Renderer* renderer);
+    bool applyBlur(SDL_Renderer* renderer);
+
+    SDL_Texture* m_target;   // Render target chứa cảnh đã chụp (đã áp dụng style)
+    SDL_Texture* m_blurred;  // Texture tĩnh chứa kết quả làm mờ
+    Uint32* m_pixels;        // Bộ đệm CPU cho kernel làm mờ
+    bool m_captured;
+};
+
+// Làm mờ hộp (box blur) ảnh ARGB8888 tại chỗ, `passes` lần để xấp xỉ Gaussian
+void BoxBlurARGB(Uint32* pixels, int width, int height, int radius, int passes);
+
+#endif
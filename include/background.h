@@ -10,12 +10,14 @@ class Background {
         void setTexture(SDL_Texture* tex);
         void setScrollSpeed(float speed);
         void update(float deltaTime);
-        void render(SDL_Renderer* renderer);
+        // alpha: vị trí giữa bước mô phỏng trước và bước hiện tại (0..1)
+        void render(SDL_Renderer* renderer, float alpha) const;
         void reset();
 
     private:
         SDL_Texture* texture;   // Con trỏ tới texture của background
         float scrollY;          // Vị trí cuộn Y hiện tại
+        float prevScrollY;      // Vị trí cuộn ở bước mô phỏng trước, dùng để nội suy khi vẽ
         float scrollSpeed;      // Tốc độ cuộn (pixels/giây)
         int textureWidth;       // Chiều rộng thực của texture
         int textureHeight;      // Chiều cao thực của texture
@@ -8,12 +8,13 @@
 #include <vector>
 #include"constants.h"
 #include<SDL_ttf.h>
+#include "resource_manager.h"
 
 class Character {
 private:
-    SDL_Rect position;
+    SDL_FRect position;   // Vị trí dạng float để di chuyển dưới mức pixel
     std::vector<SDL_Texture*> animations; // Các frame animation
-    std::vector<SDL_Texture*> costumes;   // Các trang phục
+    std::vector<TextureHandle> costumes;  // Các trang phục (dùng chung qua ResourceManager)
     int currentCostume;
     int currentFrame;
     float frameTime;
@@ -21,17 +22,23 @@ private:
     
 public:
     Character();
-    ~Character();
     
-    bool loadCostumes(SDL_Renderer* renderer, const std::vector<std::string>& costumePaths);
-    void setPosition(int x, int y);
+    // Dùng các texture đã tải sẵn làm trang phục
+    bool setCostumes(const std::vector<TextureHandle>& textures);
+    void setPosition(float x, float y);
     void setSize(int w, int h);
     void update(float deltaTime);
+    // Về frame đầu của animation, bỏ thời gian đã tích lũy
+    void resetAnimation();
     void render(SDL_Renderer* renderer);
     void nextCostume();
     void prevCostume();
     
+    // Vị trí làm tròn về pixel (cho lưới va chạm, mặt nạ)
     SDL_Rect getRect() const;
+    SDL_FRect getFRect() const;
+    // Vùng của frame animation hiện tại trong sprite sheet
+    SDL_Rect getFrameRect() const;
     int getCurrentCostume() const;
 };
 
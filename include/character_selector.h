@@ -8,27 +8,42 @@
 #include <string>
 #include "constants.h"
 #include "character.h"  // Thêm include này để sử dụng class Character
+#include "text_renderer.h"
+#include "string_table.h"
+#include "resource_manager.h"
+#include "ui_widget.h"
 
 class CharacterSelector {
 private:
-    std::vector<SDL_Texture*> characterTextures;
     std::vector<std::string> characterPaths;
     int selectedIndex = 0;
     SDL_Rect characterRect = { (SCREEN_WIDTH - 100)/2, 250, 100, 100 };
     SDL_Rect leftArrowRect = { characterRect.x - 50, characterRect.y + (characterRect.h - 30)/2, 30, 30 };
     SDL_Rect rightArrowRect = { characterRect.x + characterRect.w + 20, characterRect.y + (characterRect.h - 30)/2, 30, 30 };
-    Mix_Chunk* selectSound = nullptr;
+    ChunkHandle selectSound;
     Character character;  // Thêm thành viên Character
+    Label* nameLabel = nullptr;  // Tên trang phục, nằm trong cây giao diện của menu
+    Uint32 previewTick = 0;      // Lần cập nhật animation xem trước gần nhất (SDL_GetTicks)
     
 public:
-    bool loadResources(SDL_Renderer* renderer, const std::vector<std::string>& paths, const std::string& soundPath);
-    void handleEvent(SDL_Event* e);
-    void render(SDL_Renderer* renderer, TTF_Font* font);
+    // Nhận sprite sheet đã tải sẵn (cùng thứ tự với paths) và âm thanh chọn
+    bool loadResources(const std::vector<std::string>& paths, const std::vector<TextureHandle>& sheets, ChunkHandle sound);
+    // Thêm phần tĩnh vào cây giao diện của menu: mũi tên, chữ "Select Character" và tên nhân vật đang chọn.
+    // Mũi tên trả về UiAction::PREVIOUS_CHARACTER / NEXT_CHARACTER khi được bấm.
+    void buildUi(Widget& menu, FontFace font);
+    // Chuyển sang nhân vật trước (delta = -1) hoặc sau (delta = 1); trả về true nếu nhân vật được chọn thay đổi
+    bool step(int delta);
     std::string getSelectedCharacterPath() const;
-    ~CharacterSelector();
+    // Trả lại các handle tài nguyên, phải gọi trước SDL_DestroyRenderer
+    void release();
     
-    // Khai báo hàm renderCharacterPreview (không định nghĩa trong header)
-    void renderCharacterPreview(SDL_Renderer* renderer, TTF_Font* font);
+    // Animation xem trước chạy theo nhịp riêng CHARACTER_PREVIEW_FPS, không theo tốc độ khung hình.
+    // Trả về true nếu đã sang nhịp mới (cần vẽ lại menu)
+    bool updatePreview(Uint32 now);
+    // Số ms còn lại tới nhịp xem trước tiếp theo, dùng làm thời gian chờ sự kiện của menu
+    Uint32 previewDelay(Uint32 now) const;
+    // Chỉ vẽ frame hiện tại, animation được cập nhật trong updatePreview
+    void renderCharacterPreview(SDL_Renderer* renderer);
 };
 
 #endif // CHARACTER_SELECTOR_H
\ No newline at end of file
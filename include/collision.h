@@ -0,0 +1,41 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <SDL.h>
+#include <vector>
+
+// Kiểm tra va chạm quét (swept AABB): `a` di chuyển thêm (dx, dy) trong t ∈ [0, 1], `b` đứng yên.
+// Trả về true nếu hai hộp chồng lên nhau tại một thời điểm nào đó; *toi nhận thời điểm sớm nhất,
+// *exitTime nhận thời điểm hai hộp tách ra (giới hạn trong [0, 1]).
+// Hai hộp chỉ chạm cạnh không được tính là va chạm (giống SDL_HasIntersection).
+bool SweptAABB(const SDL_FRect& a, float dx, float dy, const SDL_FRect& b, float* toi, float* exitTime);
+
+// Mặt nạ va chạm 1 bit/pixel tạo từ kênh alpha, mỗi hàng là một dãy word 64 bit.
+// Mặt nạ có kích thước bằng kích thước khi vẽ, không phải kích thước ảnh gốc.
+class CollisionMask {
+public:
+    CollisionMask();
+
+    // Tạo từ vùng `src` của surface, co giãn (lấy mẫu gần nhất) về w x h.
+    // Pixel có alpha >= alphaThreshold được coi là đặc.
+    bool build(SDL_Surface* surface, const SDL_Rect& src, int w, int h, Uint8 alphaThreshold);
+    void clear();
+
+    bool empty() const;
+    int width() const;
+    int height() const;
+    // Lấy 64 bit bắt đầu từ cột x của hàng y (bit 0 = cột x), các cột ngoài mặt nạ là 0
+    Uint64 bitsAt(int x, int y) const;
+
+private:
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;          // Có thêm một word đệm ở cuối mỗi hàng để đọc lệch không tràn
+    std::vector<Uint64> m_bits;
+};
+
+// Narrow phase: true nếu hai mặt nạ có pixel đặc chung khi đặt góc trên-trái tại (ax, ay) và (bx, by).
+// Chỉ nên gọi sau khi phép thử AABB đã qua.
+bool MasksOverlap(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by);
+
+#endif
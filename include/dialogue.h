@@ -0,0 +1,87 @@
+#ifndef DIALOGUE_H
+#define DIALOGUE_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "asset_pack.h"
+#include "state_assets.h"
+#include "text_renderer.h"
+
+// Người nói trong kịch bản; tên được shape sẵn, ảnh chân dung gắn theo tên lúc đọc file
+struct DialogueSpeaker {
+    std::string name;
+    TextRun nameRun;            // "TÊN:"
+    std::string portraitPath;   // Rỗng nếu không có chân dung
+    SDL_Texture* portrait;      // Gắn bằng bindPortraits, nullptr khi ảnh chưa tải
+};
+
+// Một trang hội thoại đã dàn sẵn vừa khung thoại
+struct DialoguePage {
+    int speaker;                    // Chỉ số trong kịch bản, -1 nếu không có người nói
+    std::vector<TextRun> lines;
+    size_t glyphCount;              // Tổng số glyph của mọi dòng, dùng cho hiệu ứng gõ chữ
+};
+
+// Kịch bản hội thoại đọc từ file UTF-8:
+//   @portrait TÊN = đường dẫn ảnh   gắn ảnh chân dung cho người nói
+//   TÊN: lời thoại                  mỗi dòng một lời, không có "TÊN:" thì không hiện tên; "\n" là xuống dòng
+// Dòng trống và dòng bắt đầu bằng '#' bị bỏ qua. Ngắt dòng, shape và chia trang làm một lần trong layout().
+class DialogueScript {
+public:
+    DialogueScript();
+
+    // Đọc kịch bản; file có trong pack thì đọc từ pack
+    bool load(const std::string& path, const AssetPack* pack);
+    // Dàn trang cho vùng chữ textArea: tên người nói ở trên, các dòng tiếp theo, dòng nào không vừa sang trang mới
+    void layout(TextRenderer& renderer, FontFace font, const SDL_Rect& textArea);
+
+    // Ảnh chân dung của những người có lời thoại, cần tải trước khi vào cảnh
+    std::vector<std::string> portraitPaths() const;
+    // Lấy texture chân dung từ nhóm tài nguyên của cảnh (gọi lại sau khi nhóm được tải hoặc bỏ)
+    void bindPortraits(const StateAssets& assets);
+
+    size_t pageCount() const;
+    const DialoguePage& page(size_t index) const;
+    const DialogueSpeaker& speaker(int index) const;
+    const SDL_Rect& textArea() const;
+    int lineSkip() const;
+
+private:
+    struct Line {
+        int speaker;
+        std::string text;
+    };
+
+    int findSpeaker(const std::string& name);
+
+    std::vector<DialogueSpeaker> m_speakers;
+    std::vector<Line> m_lines;
+    std::vector<DialoguePage> m_pages;
+    SDL_Rect m_textArea;
+    int m_lineSkip;
+};
+
+// Tiến trình đọc một kịch bản: chữ của trang hiện tại hiện dần như đang gõ.
+// Mỗi khung hình chỉ vẽ phần đầu của các run đã dàn sẵn, không shape hay ngắt dòng lại.
+class DialoguePlayer {
+public:
+    DialoguePlayer();
+
+    void start(const DialogueScript* script);
+    void update(float dt);
+    // Người chơi bấm: hiện hết trang đang gõ, hoặc sang trang sau; false nếu đã qua trang cuối
+    bool advance();
+    bool isFinished() const;
+    bool isPageComplete() const;
+
+    // Vẽ chân dung, tên và phần chữ đã hiện của trang hiện tại; box là khung thoại
+    void render(SDL_Renderer* renderer, TextRenderer& textRenderer, FontFace font, const SDL_Rect& box) const;
+
+private:
+    const DialogueScript* m_script;
+    size_t m_page;
+    float m_revealed;   // Số glyph đã hiện của trang hiện tại
+};
+
+#endif
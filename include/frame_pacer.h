@@ -0,0 +1,59 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <SDL.h>
+#include <vector>
+
+// Thống kê thời gian khung hình (mili giây) trên cửa sổ các khung hình gần nhất
+struct FrameStats {
+    double lastMs;
+    double averageMs;
+    double minMs;
+    double maxMs;
+    double p99Ms;       // 99% khung hình nhanh hơn mức này
+    double workMs;      // Thời gian làm việc trung bình (không tính lúc chờ)
+    Uint64 frameCount;  // Tổng số khung hình từ lần resetStats
+};
+
+// Điều nhịp khung hình bằng SDL_GetPerformanceCounter.
+// Mỗi khung hình có một mốc thời gian tuyệt đối, được chờ bằng SDL_Delay rồi quay vòng ở đoạn cuối
+// nên không bị trôi như SDL_Delay cố định. Khi vsync đã giới hạn tốc độ thì không chờ thêm.
+class FramePacer {
+public:
+    FramePacer();
+
+    // fps <= 0: không giới hạn
+    void setTargetFps(int fps);
+    int targetFps() const;
+    // Báo cho pacer biết renderer có PRESENTVSYNC hay không và tần số quét của màn hình (0 nếu không rõ)
+    void setVsync(bool enabled, int refreshRate);
+
+    // Gọi ở đầu mỗi khung hình, trả về thời gian (giây) kể từ đầu khung hình trước
+    float beginFrame();
+    // Gọi sau SDL_RenderPresent, chờ tới mốc của khung hình tiếp theo
+    void endFrame();
+
+    // Tính thống kê từ vòng đệm (có cấp phát, không nên gọi mỗi khung hình)
+    FrameStats stats() const;
+    Uint64 frameCount() const;
+    void resetStats();
+
+private:
+    double toMs(Uint64 ticks) const;
+
+    Uint64 m_frequency;
+    Uint64 m_period;        // Số tick mỗi khung hình, 0 nếu không giới hạn
+    Uint64 m_frameStart;
+    Uint64 m_deadline;      // Mốc kết thúc khung hình hiện tại
+    Uint64 m_spinTicks;     // Đoạn cuối trước mốc được chờ bằng vòng lặp thay vì SDL_Delay
+    int m_targetFps;
+    bool m_vsync;
+    int m_refreshRate;
+
+    std::vector<float> m_frameMs;   // Vòng đệm thời gian khung hình
+    std::vector<float> m_workMs;
+    size_t m_head;
+    Uint64 m_frameCount;
+};
+
+#endif
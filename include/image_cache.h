@@ -0,0 +1,48 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <SDL.h>
+#include <atomic>
+#include <string>
+#include "asset_pack.h"
+
+// Bộ đệm trên đĩa cho ảnh đã giải mã (điểm ảnh ARGB8888, đúng định dạng atlas và texture dùng).
+// Mỗi ảnh nguồn có một file riêng, khoá theo đường dẫn; header ghi kích thước, mtime và hash
+// của ảnh nguồn (file rời hoặc asset trong pack) nên ảnh nguồn thay đổi thì bản đệm tự bị bỏ. Lần chạy sau chỉ cần ánh xạ file
+// và sao chép điểm ảnh thay vì giải mã JPEG/PNG. load() và store() gọi được từ nhiều worker cùng lúc.
+class ImageCache {
+public:
+    ImageCache();
+
+    // Thư mục chứa bộ đệm (tạo sẵn, kết thúc bằng dấu phân cách); chuỗi rỗng = tắt
+    void setDirectory(const std::string& directory);
+    bool isEnabled() const;
+
+    // Đọc ảnh qua bộ đệm: trả về surface ARGB8888, giải mã và ghi lại nếu bộ đệm không dùng được.
+    // Nếu pack có ảnh này thì ảnh nguồn là dữ liệu trong pack, ngược lại là file rời.
+    SDL_Surface* loadImage(const std::string& sourcePath, const AssetPack* pack = nullptr);
+
+    int hits() const;
+    int misses() const;
+
+private:
+    struct Source {
+        std::string path;
+        const Uint8* data;  // Dữ liệu trong pack, nullptr với file rời
+        Uint64 size;
+        Sint64 mtime;
+    };
+
+    bool describe(const std::string& sourcePath, const AssetPack* pack, Source* out) const;
+    // Surface ARGB8888 từ bộ đệm, nullptr nếu chưa có hoặc đã cũ
+    SDL_Surface* load(const Source& source);
+    // Ghi surface vừa giải mã vào bộ đệm
+    void store(const Source& source, SDL_Surface* surface);
+    std::string cachePath(const std::string& sourcePath) const;
+
+    std::string m_directory;
+    std::atomic<int> m_hits;
+    std::atomic<int> m_misses;
+};
+
+#endif
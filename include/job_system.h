@@ -0,0 +1,74 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <SDL.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Trạng thái của một job đã gửi; dùng làm phụ thuộc cho job khác hoặc để chờ
+struct JobState {
+    std::function<void()> work;
+    std::atomic<int> pending;           // Số phụ thuộc chưa xong (+1 trong lúc đang gửi)
+    std::atomic<bool> done;
+    std::atomic_flag lock = ATOMIC_FLAG_INIT; // Bảo vệ continuations
+    std::vector<std::shared_ptr<JobState>> continuations; // Job chờ job này xong
+    const void* group;                  // Các đoạn của cùng một parallelFor, nullptr với job thường
+
+    JobState() : pending(0), done(false), group(nullptr) {}
+};
+typedef std::shared_ptr<JobState> JobHandle;
+
+// Bộ lập lịch job kiểu work-stealing dùng chung cho cả engine.
+// Mỗi worker có một deque riêng: lấy job mới nhất ở cuối deque của mình (nóng cache),
+// khi hết việc thì lấy trộm job cũ nhất ở đầu deque của worker khác.
+class JobSystem {
+public:
+    JobSystem();
+    ~JobSystem();
+
+    // workerCount <= 0: số lõi CPU trừ luồng chính (ít nhất 1 worker)
+    bool init(int workerCount);
+    // Chờ các worker dừng; job chưa chạy bị bỏ
+    void shutdown();
+    int workerCount() const;
+
+    // Gửi job, chỉ được chạy sau khi mọi job trong deps đã xong
+    JobHandle submit(std::function<void()> work, const std::vector<JobHandle>& deps = std::vector<JobHandle>());
+    // Chờ job xong. Luồng gọi chỉ giúp chạy các job cùng nhóm với job đang chờ (worker thì giúp mọi job),
+    // hết việc thì ngủ trên condition variable tới khi có job xong.
+    void wait(const JobHandle& job);
+    // Chia [0, count) thành các đoạn dài tối đa grain, chạy song song fn(begin, end) và chờ tất cả xong.
+    // Không có worker hoặc chỉ có một đoạn thì chạy ngay trên luồng gọi.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    struct Worker {
+        std::deque<JobHandle> jobs;
+        SDL_mutex* mutex;
+        SDL_Thread* thread;
+    };
+
+    static int threadMain(void* data);
+    void workerLoop(int index);
+    void enqueue(const JobHandle& job);
+    // Lấy một job (của mình trước, sau đó đi trộm); index = -1 với luồng không phải worker
+    JobHandle takeJob(int index);
+    // Lấy một job thuộc group ở bất kỳ deque nào
+    JobHandle takeGroupJob(const void* group);
+    void execute(const JobHandle& job);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool> m_running;
+    std::atomic<int> m_queued;          // Tổng số job đang nằm trong các deque
+    std::atomic<unsigned> m_nextWorker; // Phân phối job gửi từ luồng ngoài theo vòng
+    SDL_mutex* m_sleepMutex;
+    SDL_cond* m_sleepCond;              // Worker ngủ khi không có job
+    SDL_mutex* m_doneMutex;
+    SDL_cond* m_doneCond;               // Báo cho các luồng đang wait() mỗi khi có job xong
+    std::atomic<int> m_waiters;         // Số luồng đang ngủ trong wait(), 0 thì execute không cần báo
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <SDL.h>
+#include <string>
+
+// Ánh xạ cả một file vào bộ nhớ chỉ đọc (mmap / MapViewOfFile).
+// Dữ liệu được hệ điều hành nạp theo trang khi đọc tới, không cần đọc cả file lúc mở.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const;
+    const Uint8* data() const;
+    size_t size() const;
+
+private:
+    const Uint8* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_fd;
+#endif
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef PACK_FORMAT_H
+#define PACK_FORMAT_H
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+
+// Định dạng file asset pack (assets.pak), dùng chung cho công cụ đóng gói và AssetPack.
+// [PackHeader][PackEntry + đường dẫn, căn PACK_ALIGNMENT] x count [dữ liệu từng file, căn PACK_ALIGNMENT]
+// Mọi số nguyên là little-endian; offset tính từ đầu file.
+const uint32_t PACK_MAGIC = 0x4B505647; // "GVPK"
+const uint32_t PACK_VERSION = 1;
+const uint64_t PACK_ALIGNMENT = 16;
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+struct PackEntry {
+    uint64_t offset;        // Vị trí dữ liệu
+    uint64_t size;
+    int64_t mtime;          // mtime của file gốc lúc đóng gói
+    uint32_t pathLength;    // Đường dẫn (đã chuẩn hoá) nằm ngay sau entry, không có '\0'
+    uint32_t reserved;
+};
+
+inline uint64_t PackAlign(uint64_t value) {
+    return (value + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+}
+
+// Khoá tra cứu: chữ thường, '\' thành '/', bỏ "./" ở đầu
+inline std::string NormalizeAssetPath(const std::string& path) {
+    std::string key = path;
+    for (char& c : key) {
+        c = c == '\\' ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    while (key.compare(0, 2, "./") == 0) key.erase(0, 2);
+    return key;
+}
+
+#endif
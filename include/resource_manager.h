@@ -0,0 +1,129 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <SDL_ttf.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "image_cache.h"
+#include "asset_pack.h"
+
+typedef std::shared_ptr<SDL_Texture> TextureHandle;
+typedef std::shared_ptr<Mix_Chunk> ChunkHandle;
+typedef std::shared_ptr<Mix_Music> MusicHandle;
+typedef std::shared_ptr<TTF_Font> FontHandle;
+
+struct ResourceStats {
+    int hits;       // Yêu cầu được phục vụ từ bảng, không đọc file
+    int misses;     // Yêu cầu phải đọc và giải mã file
+    int textures;
+    int chunks;
+    int music;
+    int fonts;
+    size_t textureBytes;    // Ước lượng bộ nhớ của các texture trong bảng, kể cả texture engine tự tạo
+    size_t engineTextureBytes; // Phần của textureBytes do trackTextures() báo (atlas, render target)
+    size_t textureBudget;   // 0 = không giới hạn
+    int evictions;          // Số texture đã bị bỏ vì vượt ngân sách
+};
+
+// Một dòng của báo cáo texture đang nằm trong bảng
+struct TextureUsage {
+    std::string path;
+    int width;
+    int height;
+    size_t bytes;           // w * h * bytes mỗi pixel theo định dạng của texture
+    long refs;              // Số nơi đang giữ handle, không tính bảng
+    bool pinned;
+    int count;              // Số texture gộp trong dòng (dòng của trackTextures có thể nhiều hơn 1)
+    bool engine;            // Texture engine tự tạo và tự giải phóng, không bao giờ bị bỏ
+};
+
+// Bảng tài nguyên dùng chung theo đường dẫn (không phân biệt hoa thường, '\' coi như '/').
+// Mỗi file chỉ được giải mã một lần trong cả tiến trình; nơi dùng nhận handle đếm tham chiếu.
+// Bảng giữ một tham chiếu tới mỗi tài nguyên cho tới purgeUnused() hoặc release(),
+// nên con trỏ thô lấy từ handle còn dùng được trong lúc đó. Chỉ dùng trên luồng chính.
+// Texture có ngân sách bộ nhớ: khi vượt, những texture không ghim và không còn ai giữ handle
+// bị bỏ theo thứ tự lâu không dùng nhất (LRU). Texture dùng qua con trỏ thô phải được ghim.
+class ResourceManager {
+public:
+    ResourceManager();
+    ~ResourceManager();
+
+    void setRenderer(SDL_Renderer* renderer);
+    // Texture tải đồng bộ cũng đi qua bộ đệm ảnh đã giải mã (nullptr: luôn giải mã)
+    void setImageCache(ImageCache* cache);
+    // Tài nguyên có trong pack được đọc từ pack, còn lại từ file rời (nullptr: chỉ file rời)
+    void setAssetPack(const AssetPack* pack);
+
+    // Trả về tài nguyên đã có hoặc tải từ file; handle rỗng nếu lỗi
+    TextureHandle texture(const std::string& path);
+    ChunkHandle chunk(const std::string& path);
+    MusicHandle music(const std::string& path);
+    FontHandle font(const std::string& path, int size);
+
+    // Đăng ký tài nguyên đã được tải ở nơi khác (ví dụ AssetLoader); bảng nhận quyền sở hữu.
+    // Nếu đường dẫn đã có thì giữ bản cũ và giải phóng bản mới.
+    TextureHandle addTexture(const std::string& path, SDL_Texture* texture);
+    ChunkHandle addChunk(const std::string& path, Mix_Chunk* chunk);
+    bool contains(const std::string& path) const;
+    // Ghim texture để nó không bao giờ bị bỏ vì ngân sách
+    void pinTexture(const std::string& path, bool pinned = true);
+    // Ngân sách bộ nhớ texture (byte), 0 = không giới hạn; bỏ bớt ngay nếu đang vượt
+    void setTextureBudget(size_t bytes);
+    // Ghi lại dung lượng các texture mà nơi khác tự tạo và giải phóng (atlas, render target, cache widget)
+    // dưới tên name, thay cho lần ghi trước cùng tên. Chúng được tính vào ngân sách như texture ghim
+    // và có một dòng trong báo cáo; bảng không giữ con trỏ nên gọi lại mỗi khi chúng có thể đã đổi.
+    void trackTextures(const std::string& name, const std::vector<SDL_Texture*>& textures);
+    // Bảng bỏ tham chiếu tới tài nguyên này; nó được giải phóng khi handle cuối cùng mất đi
+    void unload(const std::string& path);
+
+    // Bỏ những tài nguyên chỉ còn bảng giữ
+    void purgeUnused();
+    // Bỏ mọi tham chiếu của bảng; gọi trước SDL_DestroyRenderer và Mix_CloseAudio
+    void release();
+
+    ResourceStats stats() const;
+    // Các texture trong bảng, lớn nhất trước
+    std::vector<TextureUsage> textureUsage() const;
+
+private:
+    struct TextureEntry {
+        std::string path;       // Đường dẫn gốc (khoá đã bị chuẩn hoá)
+        TextureHandle handle;
+        size_t bytes;
+        Uint64 lastUse;         // Giá trị m_useClock lần cuối được yêu cầu
+        bool pinned;
+    };
+    struct EngineTextures {
+        size_t bytes;
+        int count;
+        int width;              // Kích thước của texture đầu tiên, để báo cáo
+        int height;
+    };
+
+    static std::string normalize(const std::string& path);
+    SDL_RWops* openRW(const std::string& path) const;
+    TextureHandle insertTexture(const std::string& key, const std::string& path, SDL_Texture* texture);
+    void enforceBudget();
+
+    SDL_Renderer* m_renderer;
+    ImageCache* m_imageCache;
+    const AssetPack* m_pack;
+    std::unordered_map<std::string, TextureEntry> m_textures;
+    size_t m_textureBytes;
+    std::unordered_map<std::string, EngineTextures> m_engineTextures;
+    size_t m_engineTextureBytes;
+    size_t m_textureBudget;
+    Uint64 m_useClock;
+    int m_evictions;
+    std::unordered_map<std::string, ChunkHandle> m_chunks;
+    std::unordered_map<std::string, MusicHandle> m_music;
+    std::unordered_map<std::string, FontHandle> m_fonts;   // Khoá: đường dẫn + "#" + cỡ chữ
+    int m_hits;
+    int m_misses;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef SCREEN_CACHE_H
+#define SCREEN_CACHE_H
+
+#include <SDL.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "constants.h"
+
+// Lưu mỗi màn hình tĩnh (MENU, GUIDE, SETTINGS) vào một texture render target.
+// Màn hình chỉ được vẽ lại khi bị invalidate, còn mỗi khung hình chỉ là một lần copy toàn màn hình.
+class ScreenCache {
+public:
+    ScreenCache();
+    ~ScreenCache();
+
+    bool init(SDL_Renderer* renderer);
+    // Giải phóng các texture, phải gọi trước SDL_DestroyRenderer
+    void release();
+
+    // Copy màn hình `state` ra renderer, gọi compose trước nếu cache chưa có hoặc đã cũ
+    void draw(GameState state, const std::function<void(SDL_Renderer*)>& compose);
+    void invalidate(GameState state);
+    void invalidateAll();
+    // Thêm các render target đang có vào out (để tính bộ nhớ texture)
+    void collectTextures(std::vector<SDL_Texture*>& out) const;
+
+private:
+    struct Entry {
+        SDL_Texture* texture;
+        bool valid;
+    };
+
+    SDL_Renderer* m_renderer;
+    bool m_targetsSupported;
+    std::unordered_map<int, Entry> m_entries;
+};
+
+#endif
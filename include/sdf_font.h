@@ -0,0 +1,68 @@
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#include <SDL.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "resource_manager.h"
+
+const int SDF_SPREAD = 6;          // Khoảng cách xa nhất (px ở cỡ gốc) được lưu quanh nét chữ
+const int SDF_ATLAS_SIZE = 1024;
+
+// Font vẽ bằng trường khoảng cách có dấu (SDF): file TTF chỉ được mở một lần ở cỡ gốc,
+// mỗi glyph được rasterize một lần rồi đổi thành khoảng cách tới biên nét và lưu vào một atlas 8 bit.
+// Mọi cỡ chữ (tiêu đề, nút, HUD) đều được suy ra từ atlas này.
+class SdfFont {
+public:
+    struct Glyph {
+        SDL_Rect src;   // Vùng trong atlas SDF (w = 0 nếu glyph không có nét)
+        int offsetX;    // Góc trên-trái của vùng so với bút vẽ và đỉnh dòng, ở cỡ gốc
+        int offsetY;
+        int advance;
+    };
+
+    SdfFont();
+
+    // font phải được mở ở cỡ baseSize; glyph ASCII in được được bake ngay
+    bool load(const FontHandle& font, int baseSize);
+    // Đóng font, gọi trước TTF_Quit
+    void release();
+    bool isLoaded() const;
+
+    // Bake glyph nếu chưa có; không bao giờ trả về nullptr
+    const Glyph* glyph(Uint32 ch);
+    // Font có glyph riêng cho ký tự này không (dùng khi chọn dạng dựng sẵn của chữ có dấu)
+    bool hasGlyph(Uint32 ch) const;
+    // Kerning giữa hai glyph, px ở cỡ gốc
+    int kerning(Uint32 prev, Uint32 ch) const;
+
+    int baseSize() const;
+    int height() const;
+    int lineSkip() const;
+    // Khoảng cách tại một điểm của atlas: 255 sâu trong nét, 128 là biên, 0 xa ngoài nét
+    const Uint8* atlas() const;
+
+private:
+    void bake(Uint32 ch, Glyph& glyph);
+    bool pack(int w, int h, SDL_Rect& outRect);
+
+    FontHandle m_font;
+    int m_baseSize;
+    int m_height;
+    int m_lineSkip;
+    std::vector<Uint8> m_atlas;
+    int m_shelfX, m_shelfY, m_shelfHeight;
+    bool m_atlasFullReported;
+    std::unordered_map<Uint32, Glyph> m_glyphs;
+};
+
+// Một cỡ chữ của SdfFont; nhẹ, truyền theo giá trị
+struct FontFace {
+    SdfFont* sdf;
+    int size;   // Tương đương cỡ truyền cho TTF_OpenFont
+
+    explicit operator bool() const { return sdf && sdf->isLoaded(); }
+};
+
+#endif
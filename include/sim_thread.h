@@ -0,0 +1,48 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <SDL.h>
+#include <atomic>
+#include <functional>
+
+// Chạy bước mô phỏng cố định (SIM_DT) trên một luồng riêng.
+// Mỗi bước được gọi trong lúc giữ mutex; luồng chính giữ cùng mutex (qua SimLock)
+// khi cần sửa trạng thái game (input, reset...). Việc vẽ chỉ đọc snapshot nên không cần khóa.
+class SimulationThread {
+public:
+    SimulationThread();
+    ~SimulationThread();
+
+    bool start(const std::function<void(float)>& step);
+    // Dừng và chờ luồng kết thúc
+    void stop();
+    // Chỉ mô phỏng khi active (đang chơi); khi bật lại, thời gian đã tạm dừng bị bỏ qua
+    void setActive(bool active);
+
+    void lock();
+    void unlock();
+
+private:
+    static int threadMain(void* data);
+    void run();
+
+    SDL_Thread* m_thread;
+    SDL_mutex* m_mutex;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_active;
+    std::function<void(float)> m_step;
+};
+
+// Giữ mutex của luồng mô phỏng trong một phạm vi
+class SimLock {
+public:
+    explicit SimLock(SimulationThread& sim) : m_sim(sim) { m_sim.lock(); }
+    ~SimLock() { m_sim.unlock(); }
+    SimLock(const SimLock&) = delete;
+    SimLock& operator=(const SimLock&) = delete;
+
+private:
+    SimulationThread& m_sim;
+};
+
+#endif
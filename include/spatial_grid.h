@@ -0,0 +1,53 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <SDL.h>
+#include <vector>
+
+// Lưới đều phủ sân chơi, dùng làm broadphase cho va chạm.
+// Mỗi phần tử (id) nhớ phạm vi ô hiện tại, nên update chỉ chạm vào các ô khi phạm vi thay đổi.
+// Mỗi phần tử cũng nhớ vị trí của nó trong từng ô, nên thêm / xoá khỏi một ô là O(1) dù ô đông đến đâu.
+// Phần tử nằm hoàn toàn ngoài sân chơi không thuộc ô nào.
+class SpatialGrid {
+public:
+    // maxItemSize: cạnh lớn nhất của phần tử; phần tử lớn hơn chỉ được ghi vào các ô ở góc trên-trái của nó
+    SpatialGrid(int width, int height, int cellSize, int maxItemSize);
+
+    void clear();
+    void insert(int id, const SDL_Rect& rect);
+    void update(int id, const SDL_Rect& rect);
+    void remove(int id);
+    // Đổi id của một phần tử (dùng khi kho dữ liệu dồn phần tử cuối vào chỗ trống)
+    void relocate(int fromId, int toId);
+    // Thêm vào out mọi id có chung ô với rect, mỗi id đúng một lần
+    void query(const SDL_Rect& rect, std::vector<int>& out);
+
+private:
+    struct CellRange {
+        Sint16 x0, y0, x1, y1;  // Bao gồm cả hai đầu; x1 < x0 nghĩa là không thuộc ô nào
+        bool operator==(const CellRange& o) const { return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1; }
+    };
+
+    struct CellEntry {
+        int id;
+        int slot;               // Thứ tự của ô này trong phạm vi của phần tử, chỉ số vào m_positions
+    };
+
+    CellRange rangeOf(const SDL_Rect& rect) const;
+    // Như rangeOf nhưng giới hạn ở m_maxSpan ô mỗi chiều, dùng cho phần tử được lưu
+    CellRange itemRangeOf(const SDL_Rect& rect) const;
+    void addToCells(int id, const CellRange& range);
+    void removeFromCells(int id, const CellRange& range);
+
+    int m_width, m_height, m_cellSize;
+    int m_cols, m_rows;
+    int m_maxSpan;                      // Số ô tối đa một phần tử phủ theo mỗi chiều
+    int m_slotsPerItem;                 // m_maxSpan * m_maxSpan
+    std::vector<std::vector<CellEntry>> m_cells;
+    std::vector<CellRange> m_ranges;    // Theo id
+    std::vector<int> m_positions;       // Theo id * m_slotsPerItem + slot: vị trí của phần tử trong ô đó
+    std::vector<Uint32> m_stamps;       // Theo id, để loại trùng trong query
+    Uint32 m_queryStamp;
+};
+
+#endif
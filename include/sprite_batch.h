@@ -0,0 +1,27 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <SDL.h>
+#include <vector>
+#include "texture_atlas.h"
+
+// Gom các sprite dùng chung một atlas và gửi chúng bằng một lệnh SDL_RenderGeometry.
+class SpriteBatch {
+public:
+    SpriteBatch();
+
+    void begin(const TextureAtlas& atlas);
+    // src là vùng con tính từ góc của region (NULL = cả region)
+    void draw(const AtlasRegion& region, const SDL_Rect* src, const SDL_FRect& dst);
+    void end(SDL_Renderer* renderer);
+
+    int spriteCount() const;
+
+private:
+    const TextureAtlas* m_atlas;
+    float m_invWidth, m_invHeight;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+};
+
+#endif
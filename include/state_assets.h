@@ -0,0 +1,47 @@
+#ifndef STATE_ASSETS_H
+#define STATE_ASSETS_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "asset_loader.h"
+#include "resource_manager.h"
+#include "job_system.h"
+
+// Nhóm texture chỉ dùng ở một trạng thái (ví dụ VICTORY): không tải lúc khởi động.
+// prefetch() giải mã ở nền khi trạng thái sắp tới, acquire() bảo đảm đã sẵn sàng lúc chuyển trạng thái,
+// evict() bỏ khỏi bộ nhớ khi không còn cần. Texture sẵn sàng được đăng ký vào ResourceManager.
+class StateAssets {
+public:
+    StateAssets(ResourceManager& resources, JobSystem* jobs, ImageCache* imageCache, const AssetPack* pack);
+    ~StateAssets();
+
+    void addTexture(const std::string& path);
+
+    // Bắt đầu giải mã ở nền nếu chưa tải
+    void prefetch();
+    // Luồng vẽ, mỗi khung hình: tạo dần texture từ ảnh đã giải mã
+    void pump(SDL_Renderer* renderer);
+    // Luồng vẽ: tải nốt (hoặc tải ngay nếu chưa prefetch) và chờ tới khi mọi texture sẵn sàng
+    void acquire(SDL_Renderer* renderer);
+    // Bỏ tham chiếu của bảng tài nguyên tới nhóm này; huỷ prefetch đang chạy
+    void evict();
+
+    bool isResident() const;
+    // nullptr nếu chưa sẵn sàng hoặc tải lỗi
+    SDL_Texture* texture(const std::string& path) const;
+
+private:
+    enum State { IDLE, LOADING, RESIDENT };
+
+    void commit();
+
+    ResourceManager& m_resources;
+    AssetLoader m_loader;
+    std::vector<std::string> m_paths;
+    std::vector<int> m_ids;
+    std::vector<TextureHandle> m_textures; // Cùng chỉ số với m_paths
+    State m_state;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef STRING_TABLE_H
+#define STRING_TABLE_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include "asset_pack.h"
+#include "text_renderer.h"
+
+// Chuỗi giao diện theo ngôn ngữ, đọc từ assets/strings/<ngôn ngữ>.txt (UTF-8).
+// Mỗi dòng "id = nội dung"; dòng trống và dòng bắt đầu bằng '#' bị bỏ qua, "\n" trong nội dung là xuống dòng.
+// Nội dung cần giữ dấu cách ở đầu/cuối thì đặt trong ngoặc kép.
+// Mỗi chuỗi được shape một lần cho mỗi cỡ chữ, các khung hình sau chỉ vẽ lại run đã lưu.
+class StringTable {
+public:
+    // Thay toàn bộ bảng bằng nội dung file; file có trong pack thì đọc từ pack
+    bool load(const std::string& path, const AssetPack* pack);
+    size_t size() const;
+
+    // id chưa có thì trả về chính id (báo lỗi một lần) để giao diện vẫn hiện được
+    const std::string& get(const std::string& id);
+    // Run đã shape của chuỗi id ở cỡ chữ font
+    const TextRun& run(TextRenderer& renderer, const std::string& id, FontFace font);
+    // Báo lỗi cho mỗi chuỗi có ký tự font không vẽ được, trả về số chuỗi như vậy
+    size_t checkCoverage(TextRenderer& renderer, const SdfFont& font);
+
+private:
+    typedef std::map<std::pair<const SdfFont*, int>, TextRun> FontRuns;
+
+    std::unordered_map<std::string, std::string> m_strings;
+    std::unordered_map<std::string, FontRuns> m_runs;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef TEXT_FILE_H
+#define TEXT_FILE_H
+
+#include <functional>
+#include <string>
+#include "asset_pack.h"
+
+// Đọc file văn bản UTF-8 (trong pack nếu có) và gọi callback cho từng dòng có nội dung.
+// BOM bị bỏ, mỗi dòng đã được cắt dấu cách hai đầu; dòng trống và dòng bắt đầu bằng '#' bị bỏ qua.
+// Trả về false nếu không đọc được file (SDL_GetError cho biết lý do).
+bool ReadTextLines(const std::string& path, const AssetPack* pack,
+                   const std::function<void(const std::string& line, int lineNumber)>& callback);
+// Cắt dấu cách, tab và '\r' ở hai đầu
+std::string TrimText(const std::string& text);
+// Đổi "\n" (hai ký tự) thành ký tự xuống dòng
+std::string UnescapeText(const std::string& text);
+
+#endif
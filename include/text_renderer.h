@@ -0,0 +1,93 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <SDL.h>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+#include "sdf_font.h"
+
+// Một glyph của chuỗi đã shape: vị trí bút tính từ đầu chuỗi, đã gồm kerning và dấu ghép
+struct ShapedGlyph {
+    Uint32 ch;
+    float x;
+};
+
+// Chuỗi đã shape cho một cỡ chữ; vẽ lại không phải giải mã UTF-8, tra kerning hay ghép dấu
+struct TextRun {
+    std::vector<ShapedGlyph> glyphs;
+    int width;
+    int height;
+};
+
+// Vẽ chữ từ một atlas glyph dùng chung cho mọi cỡ chữ.
+// Glyph của mỗi cỡ được dựng từ trường khoảng cách của SdfFont một lần (không rasterize lại TTF),
+// mỗi chuỗi được vẽ bằng một lệnh SDL_RenderGeometry.
+class TextRenderer {
+public:
+    TextRenderer();
+    ~TextRenderer();
+
+    bool init(SDL_Renderer* renderer);
+    // Giải phóng atlas, phải gọi trước SDL_DestroyRenderer
+    void release();
+
+    // Shape chuỗi UTF-8: dấu thanh / dấu mũ dạng tổ hợp (U+0300..U+036F) được ghép vào chữ trước nó,
+    // dùng glyph dựng sẵn nếu font có, không thì đặt dấu lên giữa chữ
+    void shape(FontFace font, const std::string& text, TextRun& run);
+    // Vẽ run đã shape bằng đúng font đã dùng để shape; chỉ vẽ maxGlyphs glyph đầu (hiệu ứng gõ chữ)
+    void drawRun(FontFace font, const TextRun& run, int x, int y, SDL_Color color, size_t maxGlyphs = SIZE_MAX);
+    // Vẽ chuỗi UTF-8 với góc trên-trái tại (x, y); shape lại mỗi lần gọi
+    void drawText(FontFace font, const std::string& text, int x, int y, SDL_Color color);
+    // Đo kích thước chuỗi (không rasterize gì thêm nếu glyph đã có trong atlas)
+    void measureText(FontFace font, const std::string& text, int* w, int* h);
+    // Vẽ chuỗi có xuống dòng theo từ, trả về tổng chiều cao đã vẽ
+    int drawTextWrapped(FontFace font, const std::string& text, int x, int y, int wrapWidth, SDL_Color color);
+    // Ngắt chuỗi thành các dòng rộng không quá wrapWidth (ngắt theo dấu cách và '\n')
+    void wrapLines(FontFace font, const std::string& text, int wrapWidth, std::vector<std::string>& lines);
+    // Khoảng cách giữa hai dòng liên tiếp
+    int lineSkip(FontFace font);
+    // Ký tự đầu tiên của chuỗi mà font không vẽ được (dấu tổ hợp ghép được vào chữ trước thì tính là có), 0 nếu đủ
+    Uint32 findMissingGlyph(const SdfFont& font, const std::string& text);
+    // Thêm texture atlas glyph vào out (để tính bộ nhớ texture)
+    void collectTextures(std::vector<SDL_Texture*>& out) const;
+
+private:
+    struct Glyph {
+        SDL_Rect src;   // Vị trí trong atlas (w = 0 nếu glyph trống, ví dụ dấu cách)
+        int offsetX;    // Độ lệch của ô glyph so với bút vẽ và đỉnh dòng
+        int offsetY;
+        float advance;
+    };
+    struct FontGlyphs {
+        std::unordered_map<Uint32, Glyph> glyphs;
+        float scale;    // Cỡ chữ / cỡ gốc của SdfFont
+        int height;
+        int lineSkip;
+    };
+
+    FontGlyphs* getFont(FontFace font);
+    const Glyph* getGlyph(FontFace font, FontGlyphs& entry, Uint32 ch);
+    void resolveGlyph(const SdfFont& sdf, const SdfFont::Glyph& source, float scale, Glyph& glyph);
+    bool packGlyph(SDL_Surface* glyphSurface, SDL_Rect& outRect);
+    void uploadDirty();
+
+    SDL_Renderer* m_renderer;
+    SDL_Surface* m_atlasSurface;   // Bản CPU của atlas, dùng để cập nhật từng vùng
+    SDL_Texture* m_atlasTexture;
+    int m_shelfX, m_shelfY, m_shelfHeight;
+    SDL_Rect m_dirtyRect;
+    bool m_hasDirty;
+    bool m_atlasFullReported;
+    std::map<std::pair<const SdfFont*, int>, FontGlyphs> m_fonts;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+    std::vector<std::string> m_lineScratch;
+    std::vector<Uint32> m_glyphScratch;
+    TextRun m_runScratch;
+};
+
+#endif
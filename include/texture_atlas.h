@@ -0,0 +1,47 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct AtlasRegion {
+    SDL_Rect rect;          // Vị trí (pixel) trong atlas
+    float u0, v0, u1, v1;   // Toạ độ UV đã chuẩn hoá
+};
+
+// Gom nhiều ảnh nhỏ (vật cản, sprite sheet nhân vật) vào một texture duy nhất lúc load.
+// Sau build(), mọi sprite được tra cứu qua bảng UV theo id hoặc theo tên (đường dẫn).
+class TextureAtlas {
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    // Đọc ảnh từ file và đưa vào danh sách chờ đóng gói, trả về id vùng hoặc -1 nếu lỗi
+    int addImage(const std::string& path);
+    // Đưa một surface vào danh sách chờ, atlas giữ quyền sở hữu surface
+    int addSurface(const std::string& name, SDL_Surface* surface);
+    // Đóng gói các ảnh đang chờ và tạo texture
+    bool build(SDL_Renderer* renderer);
+    // Giải phóng texture, phải gọi trước SDL_DestroyRenderer
+    void release();
+
+    bool isBuilt() const;
+    int find(const std::string& name) const;
+    const AtlasRegion& region(int id) const;
+    SDL_Texture* texture() const;
+    // Bản CPU của atlas (ARGB8888), giữ lại sau build cho các bước tiền xử lý khác
+    SDL_Surface* surface() const;
+    int width() const;
+    int height() const;
+
+private:
+    std::vector<AtlasRegion> m_regions;
+    std::vector<SDL_Surface*> m_pending;    // Surface chờ đóng gói, cùng chỉ số với m_regions
+    std::unordered_map<std::string, int> m_names;
+    SDL_Surface* m_surface;
+    SDL_Texture* m_texture;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Bộ đệm ba ô không khóa cho một luồng ghi và một luồng đọc.
+// Luồng ghi luôn có một ô riêng để ghi, luồng đọc luôn có một ô riêng để đọc;
+// ô ở giữa được tráo bằng một phép atomic nên hai bên không bao giờ phải chờ nhau.
+// Nội dung các ô được tái sử dụng, nên T giữ được bộ nhớ đã cấp phát giữa các lần ghi.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_back(0), m_middle(1), m_front(2) {}
+
+    // Ô của luồng ghi
+    T& back() { return m_slots[m_back]; }
+    // Công bố ô vừa ghi, luồng ghi nhận ô cũ ở giữa để ghi tiếp
+    void publish() {
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Lấy ô mới nhất nếu có, trả về false nếu không có gì mới từ lần trước
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    // Ô của luồng đọc
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH = 4;     // Ô giữa chứa dữ liệu chưa được đọc
+
+    T m_slots[3];
+    int m_back;
+    std::atomic<int> m_middle;
+    int m_front;
+};
+
+#endif
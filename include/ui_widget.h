@@ -0,0 +1,188 @@
+#ifndef UI_WIDGET_H
+#define UI_WIDGET_H
+
+#include <SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "constants.h"
+#include "string_table.h"
+#include "text_renderer.h"
+
+// Những gì widget cần để đo và vẽ; một bản dùng chung cho mọi cây giao diện
+struct UiContext {
+    SDL_Renderer* renderer;
+    TextRenderer* text;
+    StringTable* strings;
+    bool cacheTextures;     // false nếu renderer không hỗ trợ render target: widget vẽ thẳng mỗi lần
+};
+
+// Nút của cây giao diện giữ lại giữa các khung hình.
+// frame tính theo widget cha; vị trí tuyệt đối chỉ được tính lại khi bố cục bị invalidateLayout.
+// Widget có nội dung riêng (chữ, mũi tên) vẽ nội dung đó vào một texture của riêng nó và chỉ vẽ lại khi bị invalidate,
+// các khung hình sau chỉ copy texture đó. Widget con luôn được vẽ sau (nằm trên) widget cha.
+class Widget {
+public:
+    explicit Widget(const SDL_Rect& frame);
+    virtual ~Widget();
+    Widget(const Widget&) = delete;
+    Widget& operator=(const Widget&) = delete;
+
+    // Cây sở hữu widget con; trả về con trỏ thô để còn cập nhật về sau
+    template <typename T>
+    T* add(std::unique_ptr<T> child) {
+        T* raw = child.get();
+        adopt(std::unique_ptr<Widget>(std::move(child)));
+        return raw;
+    }
+
+    void setFrame(const SDL_Rect& frame);
+    const SDL_Rect& frame() const;
+    // Vị trí tuyệt đối trên màn hình, hợp lệ sau layout()
+    const SDL_Rect& bounds() const;
+    void setVisible(bool visible);
+    bool isVisible() const;
+    // Widget có action khác NONE thì nhận click
+    void setAction(UiAction action);
+
+    // Nội dung đổi: texture của widget này được vẽ lại ở lần render sau
+    void invalidate();
+    // Kích thước hoặc vị trí đổi: widget và các con được dàn lại ở lần layout sau
+    void invalidateLayout();
+    // Texture bị mất (SDL_RENDER_TARGETS_RESET): vẽ lại toàn bộ cây
+    void invalidateAll();
+    // Có widget nào trong cây cần dàn hoặc vẽ lại
+    bool needsRedraw() const;
+
+    // Dàn những nhánh bị đánh dấu; gọi trên gốc, render() tự gọi nếu cần
+    void layout(UiContext& ctx);
+    // Vẽ cả cây tại vị trí đã dàn
+    void render(UiContext& ctx);
+    // Một lượt hit-test: widget nhận click nằm trên cùng tại p, nullptr nếu không có
+    Widget* hitTest(SDL_Point p);
+    // Chuyển click chuột tới widget trúng hit-test, trả về action của nó (NONE nếu không trúng gì)
+    UiAction dispatch(const SDL_Event& event, UiContext& ctx);
+
+    // Huỷ texture của cả cây, phải gọi trước SDL_DestroyRenderer
+    void releaseCache();
+    // Thêm texture cache của cả cây vào out (để tính bộ nhớ texture)
+    void collectTextures(std::vector<SDL_Texture*>& out) const;
+    // Đặt vị trí tuyệt đối; widget cha gọi khi dàn các con
+    void place(const SDL_Rect& bounds);
+
+protected:
+    // Đo nội dung khi bố cục bị đánh dấu (ví dụ shape chữ); có thể đổi m_frame
+    virtual void measure(UiContext& ctx);
+    // Đặt vị trí tuyệt đối cho các con; mặc định theo frame của từng con
+    virtual void arrangeChildren();
+    // Vùng tuyệt đối mà nội dung vẽ ra, mặc định bằng bounds
+    virtual SDL_Rect paintRect() const;
+    // Vẽ nội dung riêng, mọi toạ độ tuyệt đối được cộng thêm offset
+    virtual void paint(UiContext& ctx, SDL_Point offset);
+    // Widget có nội dung đáng lưu vào texture riêng
+    virtual bool cachesContent() const;
+    // p có trúng vùng bấm của widget không; mặc định là bounds nếu widget có action
+    virtual bool hits(SDL_Point p) const;
+    // Click tại p (đã trúng hit-test), trả về action
+    virtual UiAction click(SDL_Point p);
+
+    SDL_Rect m_frame;
+    SDL_Rect m_bounds;
+    std::vector<std::unique_ptr<Widget>> m_children;
+
+private:
+    void adopt(std::unique_ptr<Widget> child);
+    void markAncestors();
+    void measureTree(UiContext& ctx, bool force);
+    void arrangeTree(bool force);
+    void renderTree(UiContext& ctx);
+    void renderContent(UiContext& ctx);
+
+    Widget* m_parent;
+    UiAction m_action;
+    bool m_visible;
+    bool m_dirty;           // Texture nội dung cần vẽ lại
+    bool m_layoutDirty;     // Widget này cần đo và dàn lại
+    bool m_descendantDirty; // Có con cháu cần dàn hoặc vẽ lại
+    SDL_Texture* m_cache;
+    SDL_Rect m_cacheRect;   // Vùng tuyệt đối mà m_cache phủ
+};
+
+// Khung chứa: nền là một texture (vẽ thẳng, không lưu thêm bản sao) hoặc màu phủ; có thể xếp các con thành cột
+class Panel : public Widget {
+public:
+    explicit Panel(const SDL_Rect& frame);
+
+    void setBackground(SDL_Texture* texture);
+    void setFill(SDL_Color color);
+    // Xếp các con từ trên xuống, bắt đầu ở top, cách nhau spacing; frame.y của con bị bỏ qua
+    void setColumn(int top, int spacing);
+
+protected:
+    void arrangeChildren() override;
+    void paint(UiContext& ctx, SDL_Point offset) override;
+    bool cachesContent() const override;
+
+private:
+    SDL_Texture* m_background;
+    SDL_Color m_fill;
+    bool m_column;
+    int m_columnTop;
+    int m_columnSpacing;
+};
+
+// Một dòng chữ, shape một lần mỗi khi nội dung đổi. Chữ được căn giữa theo chiều ngang trong frame;
+// frame.h = 0 thì chiều cao lấy theo chữ.
+class Label : public Widget {
+public:
+    Label(const SDL_Rect& frame, FontFace font, SDL_Color color);
+
+    // id trong StringTable
+    void setTextId(const std::string& id);
+    // Chuỗi hiển thị nguyên văn (ví dụ tên nhân vật)
+    void setText(const std::string& text);
+    void setColor(SDL_Color color);
+
+protected:
+    void measure(UiContext& ctx) override;
+    SDL_Rect paintRect() const override;
+    void paint(UiContext& ctx, SDL_Point offset) override;
+    virtual SDL_Rect textRect() const;
+
+    FontFace m_font;
+    SDL_Color m_color;
+    std::string m_text;
+    bool m_isId;
+    bool m_textChanged;
+    bool m_autoHeight;
+    TextRun m_run;
+};
+
+// Nút chữ: vùng bấm là frame, chữ căn giữa lệch UI_BUTTON_TEXT_OFFSET_X như ảnh nền của menu
+class Button : public Label {
+public:
+    Button(const SDL_Rect& frame, FontFace font, const std::string& textId, UiAction action);
+
+protected:
+    SDL_Rect textRect() const override;
+};
+
+// Hai mũi tên trái/phải ở hai đầu frame, căn giữa theo chiều dọc; bấm mũi tên nào trả về action của mũi tên đó
+class ArrowSelector : public Widget {
+public:
+    ArrowSelector(const SDL_Rect& frame, int arrowSize, UiAction previous, UiAction next);
+
+protected:
+    void paint(UiContext& ctx, SDL_Point offset) override;
+    bool hits(SDL_Point p) const override;
+    UiAction click(SDL_Point p) override;
+
+private:
+    SDL_Rect arrowRect(bool right) const;
+
+    int m_arrowSize;
+    UiAction m_previous;
+    UiAction m_next;
+};
+
+#endif
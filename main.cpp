@@ -8,59 +8,238 @@
 #include <random>
 #include <algorithm>
 #include <ctime>
+#include <cstdlib>
+#include <cmath>
 #include "constants.h"
 #include "character.h"
 #include "character_selector.h"
 #include "background.h"
 #include "obstacle.h"
+#include "text_renderer.h"
+#include "screen_cache.h"
+#include "backdrop.h"
+#include "texture_atlas.h"
+#include "sprite_batch.h"
+#include "collision.h"
+#include "frame_pacer.h"
+#include "triple_buffer.h"
+#include "sim_thread.h"
+#include "job_system.h"
+#include "asset_loader.h"
+#include "resource_manager.h"
+#include "state_assets.h"
+#include "image_cache.h"
+#include "asset_pack.h"
+#include "sdf_font.h"
+#include "string_table.h"
+#include "dialogue.h"
+#include "ui_widget.h"
 
-struct Button {
-    SDL_Rect rect;
-    SDL_Color color;
-    const char* text;
+// Trạng thái bất biến của một bước mô phỏng, luồng vẽ chỉ đọc từ đây
+struct GameSnapshot {
+    Uint64 publishedAt;         // SDL_GetPerformanceCounter lúc công bố
+    int score;
+    bool isGameOver;
+    bool isVictory;
+    SDL_FRect player;           // Vị trí cuối bước
+    SDL_FPoint prevPlayer;      // Vị trí đầu bước
+    SDL_Rect playerFrame;       // Frame animation trong sprite sheet
+    Background background;      // Chỉ gồm texture và vị trí cuộn, sao chép rẻ
+    ObstacleStore obstacles;
+
+    GameSnapshot() : publishedAt(0), score(0), isGameOver(false), isVictory(false),
+                     player({0.0f, 0.0f, 0.0f, 0.0f}), prevPlayer({0.0f, 0.0f}), playerFrame({0, 0, 0, 0}) {}
 };
-SDL_Rect CreateCenteredHitbox(const SDL_Rect& originalRect, int hitboxWidth, int hitboxHeight) {
-    SDL_Rect hitbox;
-    hitbox.w = hitboxWidth;
-    hitbox.h = hitboxHeight;
-    hitbox.x = originalRect.x + (originalRect.w - hitbox.w) / 2;
-    hitbox.y = originalRect.y + (originalRect.h - hitbox.h) / 2;
-    return hitbox;
-}
+
 class Game {
 private:
     ObstacleManager m_obstacleManager;
     Character character ;
     int score;
     bool isGameOver;
-    Mix_Chunk* crashSound;
-    Mix_Chunk* scoreSound;
+    ChunkHandle crashSound;
+    ChunkHandle scoreSound;
     int baseSpeed;
     Background scrollingGameBackground;
     bool isVictory;
-public:
-    Game() : score(0), isGameOver(false), baseSpeed(2),isVictory(false) {}
-    
-    void init(SDL_Renderer* renderer, const std::string& characterPath, 
-              const std::string& crashSoundPath, const std::string& scoreSoundPath,SDL_Texture* bgTex) {
-        // Load character texture
-        isGameOver = false;
-        std::vector<std::string> costumePaths = {characterPath};
-        character.loadCostumes(renderer, costumePaths);
+    FrozenBackdrop m_backdrop; // Khung hình đã chụp cho màn hình pause / game over
+    TextureAtlas m_spriteAtlas; // Atlas chung cho vật cản và sprite sheet nhân vật
+    SpriteBatch m_spriteBatch;
+    int m_playerRegion;         // Vùng sprite sheet của nhân vật đang chơi trong atlas
+    std::string m_preparedCharacter; // Nhân vật đã được chuẩn bị sẵn (mặt nạ, vùng atlas)
+    std::vector<int> m_overlaps; // Bộ đệm kết quả truy vấn va chạm
+    std::vector<SDL_FPoint> m_inputPath; // Các vị trí chuột nhận được từ lần update trước
+    std::vector<CollisionMask> m_playerMasks; // Mặt nạ va chạm theo từng frame của nhân vật
+    SDL_FPoint m_prevPlayerPos; // Vị trí nhân vật ở đầu bước mô phỏng gần nhất
+    StringTable* m_strings;
+    float m_renderAlpha;        // Hệ số nội suy của lần vẽ gần nhất (dùng lại khi chụp nền)
+    TripleBuffer<GameSnapshot> m_snapshots; // Luồng mô phỏng ghi, luồng chính đọc
 
-        // Set initial character position
-        character.setPosition(SCREEN_WIDTH/2 - 25, SCREEN_HEIGHT - 100);
-        //character.setSize(50, 50);
-        // Load sounds
+    // Kiểm tra va chạm theo cả đường đi của người chơi trong khung hình (từ startRect qua các điểm
+    // trong m_inputPath) và đoạn di chuyển của từng vật cản, nên không bị "xuyên" qua nhau khi nhanh.
+    // Sau khi hộp quét chạm nhau, mặt nạ pixel quyết định có va chạm thật hay không.
+    bool sweepPlayer(const SDL_FRect& startRect, float deltaTime) {
+        const size_t segments = std::max<size_t>(1, m_inputPath.size());
+
+        // Broadphase: hộp bao cả đường đi, kéo dài xuống dưới bằng quãng đường lớn nhất của vật cản
+        float minX = startRect.x, minY = startRect.y, maxX = startRect.x, maxY = startRect.y;
+        for (const SDL_FPoint& p : m_inputPath) {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        }
+        SDL_Rect query;
+        query.x = static_cast<int>(std::floor(minX));
+        query.y = static_cast<int>(std::floor(minY));
+        query.w = static_cast<int>(std::ceil(maxX + startRect.w)) - query.x + 1;
+        query.h = static_cast<int>(std::ceil(maxY + startRect.h + m_obstacleManager.maxStep(deltaTime))) - query.y + 1;
+        m_overlaps.clear();
+        m_obstacleManager.queryCandidates(query, m_overlaps);
+        if (m_overlaps.empty()) return false;
+
+        const CollisionMask* playerMask = currentPlayerMask();
+        const ObstacleStore& obstacles = m_obstacleManager.getObstacles();
+        SDL_FPoint from = {startRect.x, startRect.y};
+        for (size_t k = 0; k < segments; ++k) {
+            SDL_FPoint to = from;
+            if (!m_inputPath.empty()) {
+                to = m_inputPath[k];
+            }
+            // Mỗi đoạn chuột chiếm một phần bằng nhau của khung hình
+            float t0 = static_cast<float>(k) / segments;
+            float t1 = static_cast<float>(k + 1) / segments;
+            SDL_FRect playerBox = {from.x, from.y, startRect.w, startRect.h};
+            for (int id : m_overlaps) {
+                float obstacleDy = obstacles.y[id] - obstacles.prevY[id];
+                SDL_FRect obstacleBox = {obstacles.x[id], obstacles.prevY[id] + obstacleDy * t0,
+                                         static_cast<float>(OBSTACLE_SIZE), static_cast<float>(OBSTACLE_SIZE)};
+                // Xét trong hệ quy chiếu của vật cản: vật cản đứng yên, người chơi đi theo chuyển động tương đối
+                float relDx = to.x - from.x;
+                float relDy = (to.y - from.y) - obstacleDy * (t1 - t0);
+                float enter = 0.0f, exit = 0.0f;
+                if (!SweptAABB(playerBox, relDx, relDy, obstacleBox, &enter, &exit)) continue;
+
+                const CollisionMask* obstacleMask = m_obstacleManager.mask(obstacles.texture[id]);
+                if (!playerMask || !obstacleMask) return true; // Không có mặt nạ thì dùng kết quả AABB
 
-        crashSound = Mix_LoadWAV(crashSoundPath.c_str());
-        scoreSound = Mix_LoadWAV(scoreSoundPath.c_str());
+                // Lấy mẫu khoảng thời gian hai hộp chồng nhau, mỗi bước dịch tương đối tối đa khoảng 1 pixel
+                float span = std::max(std::fabs(relDx), std::fabs(relDy)) * (exit - enter);
+                int steps = std::max(1, std::min(MASK_SWEEP_MAX_STEPS, static_cast<int>(std::ceil(span))));
+                for (int i = 0; i <= steps; ++i) {
+                    float s = enter + (exit - enter) * i / steps;
+                    int px = static_cast<int>(std::lround(from.x + (to.x - from.x) * s));
+                    int py = static_cast<int>(std::lround(from.y + (to.y - from.y) * s));
+                    int ox = static_cast<int>(std::lround(obstacles.x[id]));
+                    int oy = static_cast<int>(std::lround(obstacles.prevY[id] + obstacleDy * (t0 + (t1 - t0) * s)));
+                    if (MasksOverlap(*playerMask, px, py, *obstacleMask, ox, oy)) {
+                        return true;
+                    }
+                }
+            }
+            from = to;
+        }
+        return false;
+    }
+
+    // Mặt nạ của frame animation nhân vật đang hiển thị
+    const CollisionMask* currentPlayerMask() const {
+        SDL_Rect frame = character.getFrameRect();
+        size_t index = frame.w > 0 ? static_cast<size_t>(frame.x / frame.w) : 0;
+        if (index >= m_playerMasks.size() || m_playerMasks[index].empty()) return nullptr;
+        return &m_playerMasks[index];
+    }
 
-        m_obstacleManager.loadTextures(renderer);
+    // Tạo mặt nạ cho từng frame của sprite sheet nhân vật đang chơi
+    void buildPlayerMasks() {
+        m_playerMasks.clear();
+        if (m_playerRegion < 0 || !m_spriteAtlas.surface()) return;
+        const SDL_Rect& sheet = m_spriteAtlas.region(m_playerRegion).rect;
+        // Cắt frame theo kích thước trong sprite sheet, mặt nạ theo kích thước vẽ trên màn hình
+        SDL_Rect frameRect = character.getFrameRect();
+        SDL_Rect pos = character.getRect();
+        for (int frame = 0; frame < CHARACTER_FRAME_COUNT; ++frame) {
+            SDL_Rect src = {sheet.x + frame * frameRect.w, sheet.y, frameRect.w, frameRect.h};
+            if (src.x + src.w > sheet.x + sheet.w || src.h > sheet.h) break;
+            m_playerMasks.emplace_back();
+            m_playerMasks.back().build(m_spriteAtlas.surface(), src, pos.w, pos.h, COLLISION_ALPHA_THRESHOLD);
+        }
+    }
+
+    // Vẽ từ snapshot mới nhất, không đọc trạng thái mà luồng mô phỏng đang ghi
+    void renderScene(SDL_Renderer* renderer, TextRenderer& textRenderer, FontFace font) {
+        const GameSnapshot& view = m_snapshots.front();
+        view.background.render(renderer, m_renderAlpha);
+
+        // Nhân vật và vật cản được gửi chung trong một lệnh vẽ
+        m_spriteBatch.begin(m_spriteAtlas);
+        if (m_playerRegion >= 0) {
+            const SDL_FRect& pos = view.player;
+            SDL_FRect dst = {view.prevPlayer.x + (pos.x - view.prevPlayer.x) * m_renderAlpha,
+                             view.prevPlayer.y + (pos.y - view.prevPlayer.y) * m_renderAlpha,
+                             pos.w, pos.h};
+            m_spriteBatch.draw(m_spriteAtlas.region(m_playerRegion), &view.playerFrame, dst);
+        }
+        m_obstacleManager.render(m_spriteBatch, m_spriteAtlas, view.obstacles, m_renderAlpha);
+        m_spriteBatch.end(renderer);
+        
+        // Draw score: nhãn đã shape sẵn, chỉ phần số được shape mỗi khung hình
+        if (font && m_strings) {
+            SDL_Color textColor = {255, 255, 255, 255};
+            const TextRun& label = m_strings->run(textRenderer, "game.score", font);
+            int spaceW = 0;
+            textRenderer.measureText(font, " ", &spaceW, nullptr);
+            textRenderer.drawRun(font, label, 30, 30, textColor);
+            textRenderer.drawText(font, std::to_string(view.score), 30 + label.width + spaceW, 30, textColor);
+        }
+    }
+public:
+    Game() : score(0), isGameOver(false), baseSpeed(2),isVictory(false), m_playerRegion(-1),
+             m_prevPlayerPos({0.0f, 0.0f}), m_strings(nullptr), m_renderAlpha(1.0f) {}
+
+    // Đưa ảnh đã giải mã sẵn vào atlas trước loadSprites để ảnh đó không bị đọc lại từ file
+    void addSpriteSurface(const std::string& name, SDL_Surface* surface) {
+        m_spriteAtlas.addSurface(name, surface);
+    }
+
+    // Đóng gói ảnh vật cản và tất cả sprite sheet nhân vật vào atlas, chỉ cần gọi một lần
+    bool loadSprites(SDL_Renderer* renderer, const std::vector<std::string>& characterPaths) {
+        if (m_spriteAtlas.isBuilt()) return true;
+        m_obstacleManager.loadTextures(m_spriteAtlas);
+        for (const auto& path : characterPaths) {
+            m_spriteAtlas.addImage(path);
+        }
+        if (!m_spriteAtlas.build(renderer)) return false;
+        m_obstacleManager.buildMasks(m_spriteAtlas);
+        return true;
+    }
     
+    // Chuẩn bị sẵn mọi thứ cho ván chơi trong lúc người chơi còn ở menu (gọi lại khi đổi nhân vật),
+    // để khi bấm Play chỉ còn reset(). Âm thanh lấy từ ResourceManager nên đã được tải sẵn.
+    void prepare(SDL_Renderer* renderer, const std::string& characterPath,
+                 ChunkHandle crash, ChunkHandle scoreChunk, SDL_Texture* bgTex) {
+        loadSprites(renderer, {characterPath});
+        if (characterPath != m_preparedCharacter) {
+            m_playerRegion = m_spriteAtlas.find(characterPath);
+            buildPlayerMasks();
+            m_preparedCharacter = characterPath;
+        }
+
+        crashSound = crash;
+        scoreSound = scoreChunk;
+
         if (bgTex) {
-        scrollingGameBackground.setTexture(bgTex);
-    }
+            scrollingGameBackground.setTexture(bgTex);
+        }
+        m_obstacleManager.prepareInitialState();
+
+        // Cấp phát trước bộ nhớ vật cản cho cả ba ô snapshot, để ván đầu tiên không phải cấp phát
+        for (int slot = 0; slot < 3; ++slot) {
+            m_snapshots.back().obstacles.reserve(static_cast<size_t>(m_obstacleManager.getDensity()));
+            m_snapshots.publish();
+            m_snapshots.acquire();
+        }
+        reset();
     }
     
     void handleEvent(SDL_Event* e) {
@@ -71,38 +250,52 @@ public:
             return;
         }
         if (e->type == SDL_MOUSEMOTION) {
-        int x = e->motion.x - character.getRect().w/2;
-        x = std::max(0, std::min(x, SCREEN_WIDTH - character.getRect().w));
-        int y= e->motion.y - character.getRect().h/2;
-        y = std::max(0, std::min(y, SCREEN_HEIGHT - character.getRect().h));
-        character.setPosition(x,y);
+        SDL_FRect rect = character.getFRect();
+        float x = e->motion.x - rect.w / 2.0f;
+        x = std::max(0.0f, std::min(x, SCREEN_WIDTH - rect.w));
+        float y = e->motion.y - rect.h / 2.0f;
+        y = std::max(0.0f, std::min(y, SCREEN_HEIGHT - rect.h));
+        // Chỉ ghi lại, vị trí được áp dụng trong update sau khi kiểm tra cả đường đi
+        m_inputPath.push_back({x, y});
     }
 }
+    // Một bước mô phỏng với deltaTime = SIM_DT cố định, rồi công bố snapshot (chạy trên luồng mô phỏng)
+    void step(float deltaTime) {
+        update(deltaTime);
+        publishSnapshot();
+    }
+
     void update(float deltaTime) {
         if (isGameOver||isVictory) return;
 
+        SDL_FRect startRect = character.getFRect();
+        m_prevPlayerPos = {startRect.x, startRect.y};
+
         character.update(deltaTime);
 
         scrollingGameBackground.update(deltaTime);
         
         m_obstacleManager.setBaseSpeedFactor(this->baseSpeed);
 
-        m_obstacleManager.update(deltaTime, this->score, this->scoreSound);
+        m_obstacleManager.update(deltaTime, this->score, this->scoreSound.get());
+
+        if (!m_inputPath.empty()) {
+            character.setPosition(m_inputPath.back().x, m_inputPath.back().y);
+        }
 
-        if (this->score >= 500) { // Điều kiện thắng là 500 điểm
+        // Chế độ mật độ cao chỉ dùng để đo hiệu năng: không thắng, va chạm không kết thúc game
+        bool stressMode = isStressMode();
+        if (this->score >= VICTORY_SCORE && !stressMode) {
             this->isVictory = true;
+            m_inputPath.clear();
             return;
         }
-        SDL_Rect originalCharRect = character.getRect();
-        const int CHARACTER_HITBOX_WIDTH = 30; 
-        const int CHARACTER_HITBOX_HEIGHT = 30;
-        SDL_Rect charCustomHitbox = CreateCenteredHitbox(originalCharRect, CHARACTER_HITBOX_WIDTH, CHARACTER_HITBOX_HEIGHT);
-        for (const auto& obstacle : m_obstacleManager.getObstacles()) { // Lấy vật cản từ manager
-            if (SDL_HasIntersection(&charCustomHitbox, &obstacle.rect)) {
-                isGameOver = true;
-                if (crashSound) Mix_PlayChannel(-1, crashSound, 0);
-                return;
-            }
+        bool hit = sweepPlayer(startRect, deltaTime);
+        m_inputPath.clear();
+        if (hit && !stressMode) {
+            isGameOver = true;
+            if (crashSound) Mix_PlayChannel(-1, crashSound.get(), 0);
+            return;
         }
         
         if (score % 10 == 0 && score > 0) {
@@ -110,150 +303,196 @@ public:
         }
     }
     
-    void render(SDL_Renderer* renderer, TTF_Font* font) {
+    // Ghi trạng thái hiện tại vào ô ghi của bộ đệm ba ô và công bố.
+    // Phải gọi khi đang giữ khóa mô phỏng (hoặc khi luồng mô phỏng chưa chạy).
+    void publishSnapshot() {
+        GameSnapshot& snapshot = m_snapshots.back();
+        snapshot.publishedAt = SDL_GetPerformanceCounter();
+        snapshot.score = score;
+        snapshot.isGameOver = isGameOver;
+        snapshot.isVictory = isVictory;
+        snapshot.player = character.getFRect();
+        snapshot.prevPlayer = m_prevPlayerPos;
+        snapshot.playerFrame = character.getFrameRect();
+        snapshot.background = scrollingGameBackground;
+        m_obstacleManager.copyState(snapshot.obstacles);
+        m_snapshots.publish();
+    }
 
-        scrollingGameBackground.render(renderer);
+    // Luồng chính gọi ở đầu mỗi khung hình để lấy snapshot mới nhất
+    void acquireSnapshot() {
+        m_snapshots.acquire();
+    }
 
-        // Draw character
-        character.render(renderer);
-        
-        // Draw obstacles
-        m_obstacleManager.render(renderer);
-        
-        // Draw score
-        if (font) {
-            std::string scoreText = "Score: " + std::to_string(score);
-            SDL_Color textColor = {255, 255, 255, 255};
-            SDL_Surface* textSurface = TTF_RenderText_Solid(font, scoreText.c_str(), textColor);
-            if (textSurface) {
-                SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-                if (textTexture) {
-                    SDL_Rect textRect = {30, 30, textSurface->w, textSurface->h};
-                    SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-                    SDL_DestroyTexture(textTexture);
-                }
-                SDL_FreeSurface(textSurface);
-            }
+    // Vẽ snapshot hiện tại, nội suy theo thời gian đã trôi qua kể từ lúc snapshot được công bố
+    void render(SDL_Renderer* renderer, TextRenderer& textRenderer, FontFace font) {
+        const GameSnapshot& view = m_snapshots.front();
+        float alpha = static_cast<float>(SDL_GetPerformanceCounter() - view.publishedAt)
+                    / (SDL_GetPerformanceFrequency() * SIM_DT);
+        m_renderAlpha = std::max(0.0f, std::min(alpha, 1.0f));
+        if (!view.isGameOver) {
+            renderScene(renderer, textRenderer, font);
+            return;
         }
-        
-        // Game over screen
-        if (isGameOver) {
-            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
-            SDL_Rect overlay = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-            SDL_RenderFillRect(renderer, &overlay);
-            
-            if (font) {
+
+        // Game over screen: cảnh phía sau chỉ được chụp và làm tối một lần
+        if (!m_backdrop.isCaptured()) {
+            freeze(renderer, textRenderer, font, BackdropStyle::DIM, 180);
+        }
+        renderFrozen(renderer, textRenderer, font);
+
+        {
+            if (font && m_strings) {
                 SDL_Color textColor = {255, 255, 255, 255};
+
+                const TextRun& gameOverText = m_strings->run(textRenderer, "game.over", font);
+                textRenderer.drawRun(font, gameOverText, (SCREEN_WIDTH - gameOverText.width)/2, SCREEN_HEIGHT/2 - 50, textColor);
                 
-                std::string gameOverText = "Game Over!";
-                SDL_Surface* gameOverSurface = TTF_RenderText_Solid(font, gameOverText.c_str(), textColor);
-                if (gameOverSurface) {
-                    SDL_Texture* gameOverTexture = SDL_CreateTextureFromSurface(renderer, gameOverSurface);
-                    if (gameOverTexture) {
-                        SDL_Rect gameOverRect = {
-                            (SCREEN_WIDTH - gameOverSurface->w)/2,
-                            SCREEN_HEIGHT/2 - 50,
-                            gameOverSurface->w,
-                            gameOverSurface->h
-                        };
-                        SDL_RenderCopy(renderer, gameOverTexture, NULL, &gameOverRect);
-                        SDL_DestroyTexture(gameOverTexture);
-                    }
-                    SDL_FreeSurface(gameOverSurface);
-                }
-                
-                std::string scoreText = "Score: " + std::to_string(score);
-                SDL_Surface* scoreSurface = TTF_RenderText_Solid(font, scoreText.c_str(), textColor);
-                if (scoreSurface) {
-                    SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-                    if (scoreTexture) {
-                        SDL_Rect scoreRect = {
-                            (SCREEN_WIDTH - scoreSurface->w)/2,
-                            SCREEN_HEIGHT/2,
-                            scoreSurface->w,
-                            scoreSurface->h
-                        };
-                        SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreRect);
-                        SDL_DestroyTexture(scoreTexture);
-                    }
-                    SDL_FreeSurface(scoreSurface);
-                }
+                std::string scoreText = m_strings->get("game.score") + " " + std::to_string(m_snapshots.front().score);
+                int textW = 0;
+                textRenderer.measureText(font, scoreText, &textW, nullptr);
+                textRenderer.drawText(font, scoreText, (SCREEN_WIDTH - textW)/2, SCREEN_HEIGHT/2, textColor);
                 
-                std::string instructionText = "Click to play again";
-                SDL_Surface* instructionSurface = TTF_RenderText_Solid(font, instructionText.c_str(), textColor);
-                if (instructionSurface) {
-                    SDL_Texture* instructionTexture = SDL_CreateTextureFromSurface(renderer, instructionSurface);
-                    if (instructionTexture) {
-                        SDL_Rect instructionRect = {
-                            (SCREEN_WIDTH - instructionSurface->w)/2,
-                            SCREEN_HEIGHT/2 + 50,
-                            instructionSurface->w,
-                            instructionSurface->h
-                        };
-                        SDL_RenderCopy(renderer, instructionTexture, NULL, &instructionRect);
-                        SDL_DestroyTexture(instructionTexture);
-                    }
-                    SDL_FreeSurface(instructionSurface);
-                }
+                const TextRun& instructionText = m_strings->run(textRenderer, "game.again", font);
+                textRenderer.drawRun(font, instructionText, (SCREEN_WIDTH - instructionText.width)/2, SCREEN_HEIGHT/2 + 50, textColor);
             }
         }
     }
     
+    // Chụp khung hình hiện tại làm nền cho lớp phủ (pause / game over)
+    // Mô phỏng phải đã dừng; cảnh được chụp đúng ở cuối bước cuối cùng (không nội suy)
+    void freeze(SDL_Renderer* renderer, TextRenderer& textRenderer, FontFace font, BackdropStyle style, Uint8 dimAlpha) {
+        m_renderAlpha = 1.0f;
+        m_backdrop.capture(renderer, [&](SDL_Renderer* target) {
+            renderScene(target, textRenderer, font);
+        }, style, dimAlpha);
+    }
+
+    void renderFrozen(SDL_Renderer* renderer, TextRenderer& textRenderer, FontFace font) {
+        if (m_backdrop.isCaptured()) {
+            m_backdrop.render(renderer);
+            return;
+        }
+        // Không có render target: vẽ lại cảnh và lớp phủ như cũ
+        renderScene(renderer, textRenderer, font);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+        SDL_Rect overlay = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        SDL_RenderFillRect(renderer, &overlay);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    }
+
+    void unfreeze() {
+        m_backdrop.invalidate();
+    }
+
+    // Texture Game tự tạo, để báo dung lượng cho ResourceManager
+    const TextureAtlas& spriteAtlas() const { return m_spriteAtlas; }
+    const FrozenBackdrop& backdrop() const { return m_backdrop; }
+
+    // Giải phóng texture và trả lại handle âm thanh của Game, phải gọi trước SDL_DestroyRenderer
+    void release() {
+        m_backdrop.release();
+        m_spriteAtlas.release();
+        crashSound.reset();
+        scoreSound.reset();
+    }
+
+    // Khôi phục trạng thái đầu ván đã chuẩn bị sẵn, không cấp phát và không đọc file.
+    // Mọi thứ step() đọc (kể cả frame animation, vì frame chọn mặt nạ va chạm) phải được đặt lại ở đây,
+    // để cùng --seed và cùng chuỗi input luôn cho cùng một ván.
     void reset() {
+        m_backdrop.invalidate();
+        m_inputPath.clear();
+        character.setPosition(SCREEN_WIDTH/2 - 25, SCREEN_HEIGHT - 100);
+        character.resetAnimation();
+        m_prevPlayerPos = {character.getFRect().x, character.getFRect().y};
         score = 0;
         isGameOver = false;
         isVictory = false;
-        baseSpeed = 2;
+        baseSpeed = INITIAL_SPEED_FACTOR;
         scrollingGameBackground.reset();
         m_obstacleManager.reset();
+        // Luồng chính cần thấy ván mới ngay, không chờ bước mô phỏng tiếp theo
+        publishSnapshot();
+        acquireSnapshot();
     }
     
-    bool gameOver() const { return isGameOver;}
-    bool hasWon() const { return isVictory; }
-    
-    ~Game() {
-        if (crashSound) Mix_FreeChunk(crashSound);
-        if (scoreSound) Mix_FreeChunk(scoreSound);
+    // Sinh sẵn vật cản cho ván sau khi mô phỏng đang dừng (menu, pause, thua, thắng),
+    // vì không có --seed thì mỗi lần reset() dùng hết trạng thái đã chuẩn bị
+    void prepareNextRound() {
+        m_obstacleManager.prepareInitialState();
     }
-};
 
-SDL_Texture* LoadTexture(const std::string& path, SDL_Renderer* renderer) {
-    SDL_Surface* surface = IMG_Load(path.c_str());
-    if (!surface) {
-        std::cerr << "Failed to load image: " << path << " - " << IMG_GetError() << std::endl;
-        return nullptr;
+    void setObstacleDensity(int maxObstacles) {
+        m_obstacleManager.setDensity(maxObstacles);
     }
-    
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
-    
-    if (!texture) {
-        std::cerr << "Failed to create texture: " << path << " - " << SDL_GetError() << std::endl;
+
+    // Chế độ mật độ cao (--density) để đo hiệu năng: không thua, không thắng
+    bool isStressMode() const {
+        return m_obstacleManager.getDensity() > MAX_OBSTACLES;
     }
-    return texture;
-}
 
-void DrawButton(SDL_Renderer* renderer, const Button& button, TTF_Font* font) {
-
-    if (font && button.text) {
-        SDL_Color textColor = { 255, 255, 255, 255 };
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, button.text, textColor);
-        if (textSurface) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            if (textTexture) {
-                int textX = button.rect.x + (button.rect.w - textSurface->w) / 2-25;
-                int textY = button.rect.y + (button.rect.h - textSurface->h) / 2;
-                SDL_Rect textRect = { textX, textY, textSurface->w, textSurface->h };
-                SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-                SDL_DestroyTexture(textTexture);
-            }
-            SDL_FreeSurface(textSurface);
-        }
+    void setSeed(Uint32 seed) {
+        m_obstacleManager.setSeed(seed);
     }
-}
+
+    void setJobSystem(JobSystem* jobs) {
+        m_obstacleManager.setJobSystem(jobs);
+    }
+
+    void setStrings(StringTable* strings) {
+        m_strings = strings;
+    }
+
+    // Đọc từ snapshot của luồng chính
+    bool gameOver() const { return m_snapshots.front().isGameOver; }
+    bool hasWon() const { return m_snapshots.front().isVictory; }
+    int currentScore() const { return m_snapshots.front().score; }
+};
 
 int main(int argc, char* argv[]) {
+    // Tham số dòng lệnh: --density N bật chế độ mật độ cao với N vật cản (tối đa MAX_STRESS_OBSTACLES)
+    // --seed N cố định chuỗi vật cản để tái hiện một ván chơi
+    // --fps N giới hạn tốc độ khung hình (0 = không giới hạn, mặc định theo tần số quét màn hình)
+    // --vsync bật PRESENTVSYNC, --frame-stats in thống kê thời gian khung hình định kỳ
+    // --texture-budget N giới hạn bộ nhớ texture ở N MB (0 = không giới hạn), --texture-report in từng texture khi thoát
+    // --no-image-cache luôn giải mã ảnh gốc, không đọc/ghi bộ đệm ảnh đã giải mã
+    // --lang X đọc chuỗi giao diện từ assets/strings/X.txt (mặc định DEFAULT_LANGUAGE)
+    int obstacleDensity = MAX_OBSTACLES;
+    int targetFps = -1;
+    bool useVsync = false;
+    bool printFrameStats = false;
+    int textureBudgetMb = DEFAULT_TEXTURE_BUDGET_MB;
+    bool printTextureReport = false;
+    bool useImageCache = true;
+    std::string language = DEFAULT_LANGUAGE;
+    bool hasSeed = false;
+    Uint32 seed = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--density" && i + 1 < argc) {
+            obstacleDensity = std::max(1, std::min(std::atoi(argv[++i]), MAX_STRESS_OBSTACLES));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<Uint32>(std::strtoul(argv[++i], nullptr, 10));
+            hasSeed = true;
+        } else if (arg == "--fps" && i + 1 < argc) {
+            targetFps = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--vsync") {
+            useVsync = true;
+        } else if (arg == "--frame-stats") {
+            printFrameStats = true;
+        } else if (arg == "--texture-budget" && i + 1 < argc) {
+            textureBudgetMb = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--texture-report") {
+            printTextureReport = true;
+        } else if (arg == "--no-image-cache") {
+            useImageCache = false;
+        } else if (arg == "--lang" && i + 1 < argc) {
+            language = argv[++i];
+        }
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         std::cerr << "SDL initialization failed: " << SDL_GetError() << std::endl;
         return -1;
@@ -276,10 +515,27 @@ int main(int argc, char* argv[]) {
         std::cerr << "SDL_mixer initialization failed: " << Mix_GetError() << std::endl;
     }
 
-    Mix_Music* bgMusic = Mix_LoadMUS("assets/sounds/background.mp3");
-    Mix_Chunk* buttonSound = Mix_LoadWAV("assets/sounds/button.mp3");
-    Mix_Chunk* crashSound = Mix_LoadWAV("assets/sounds/crash.mp3");
-    Mix_Chunk* scoreSound = Mix_LoadWAV("assets/sounds/score.mp3");
+    // Bản phát hành đọc tài nguyên từ một file pack ánh xạ vào bộ nhớ (make pack);
+    // không có pack thì đọc file rời như khi phát triển. Khai báo trước bảng tài nguyên để còn mở
+    // chừng nào font và nhạc nền còn đọc từ pack.
+    AssetPack assetPack;
+    assetPack.open(ASSET_PACK_PATH);
+    const AssetPack* pack = assetPack.isOpen() ? &assetPack : nullptr;
+
+    // Mọi tài nguyên dùng chung đi qua bảng này, mỗi file chỉ được giải mã một lần.
+    // Bảng giữ tài nguyên tới lúc thoát nên con trỏ thô bên dưới luôn hợp lệ.
+    ResourceManager resources;
+    resources.setAssetPack(pack);
+
+    // Chuỗi giao diện nhỏ nên đọc ngay, trước màn hình LOADING
+    StringTable strings;
+    if (!strings.load("assets/strings/" + language + ".txt", pack) && language != DEFAULT_LANGUAGE) {
+        strings.load(std::string("assets/strings/") + DEFAULT_LANGUAGE + ".txt", pack);
+    }
+
+    // Nhạc nền được đọc dần khi phát nên mở ngay; các âm thanh ngắn do AssetLoader giải mã
+    Mix_Music* bgMusic = resources.music("assets/sounds/background.mp3").get();
+    Mix_Chunk* buttonSound = nullptr;
     
     if (bgMusic) {
         Mix_PlayMusic(bgMusic, -1);
@@ -304,7 +560,9 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+    if (useVsync) rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, rendererFlags);
     if (!renderer) {
         std::cerr << "Renderer creation failed: " << SDL_GetError() << std::endl;
         SDL_DestroyWindow(window);
@@ -315,34 +573,126 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
-    TTF_Font* font = TTF_OpenFont("assets/fonts/1.ttf", 50);
-    TTF_Font* titleFont = TTF_OpenFont("assets/fonts/1.ttf", 100);
-    TTF_Font* selectFont = TTF_OpenFont("assets/fonts/1.ttf", 30);
-    if (!font || !titleFont || !selectFont) {
+    resources.setRenderer(renderer);
+
+    // Ảnh đã giải mã được lưu trong thư mục dữ liệu của người dùng, lần chạy sau không phải giải mã lại
+    ImageCache imageCache;
+    if (useImageCache) {
+        char* prefPath = SDL_GetPrefPath("dinhtuanz", "GameVjpp");
+        if (prefPath) {
+            imageCache.setDirectory(prefPath);
+            SDL_free(prefPath);
+        } else {
+            std::cerr << "Image cache disabled: " << SDL_GetError() << std::endl;
+        }
+    }
+    resources.setImageCache(&imageCache);
+    resources.setTextureBudget(static_cast<size_t>(textureBudgetMb) * 1024 * 1024);
+
+    TextRenderer textRenderer;
+    if (!textRenderer.init(renderer)) {
+        std::cerr << "Failed to create text renderer!" << std::endl;
+    }
+
+    ScreenCache screenCache;
+    screenCache.init(renderer);
+
+    // Font chỉ được mở một lần; mọi cỡ chữ được dựng từ cùng một atlas SDF
+    SdfFont uiFont;
+    if (!uiFont.load(resources.font("assets/fonts/1.ttf", SDF_BASE_SIZE), SDF_BASE_SIZE)) {
         std::cerr << "Failed to load fonts: " << TTF_GetError() << std::endl;
     }
+    // Font không đủ chữ cho ngôn ngữ đã chọn thì dùng ngôn ngữ mặc định thay vì hiện chữ thiếu dấu
+    if (strings.checkCoverage(textRenderer, uiFont) > 0 && language != DEFAULT_LANGUAGE) {
+        std::cerr << "Font does not cover language " << language << ", using " << DEFAULT_LANGUAGE << std::endl;
+        language = DEFAULT_LANGUAGE;
+        strings.load(std::string("assets/strings/") + DEFAULT_LANGUAGE + ".txt", pack);
+    }
+    FontFace font = {&uiFont, 50};
+    FontFace titleFont = {&uiFont, 100};
+    FontFace selectFont = {&uiFont, 30};
 
-    SDL_Texture* background = LoadTexture("assets/images/background.jpg", renderer);
-    SDL_Texture* gameBackground = LoadTexture("assets/images/game_background.jpg", renderer);
+    // Các worker dùng chung cho mọi hệ thống, không hệ thống nào tự tạo luồng riêng
+    JobSystem jobSystem;
+    if (!jobSystem.init(0)) {
+        std::cerr << "Failed to start job workers, running single-threaded" << std::endl;
+    }
 
+    const std::vector<std::string> characterSheets = {
+        "assets/images/characters/Elf.png",
+        "assets/images/characters/Wizart.png", 
+        "assets/images/characters/Knight.png"
+    };
+
+    // Ảnh và âm thanh được giải mã song song trên các worker trong lúc màn hình LOADING hiện tiến độ;
+    // texture được tạo dần trên luồng chính, mỗi khung hình vài cái
+    AssetLoader assetLoader;
+    assetLoader.setJobSystem(&jobSystem);
+    assetLoader.setImageCache(&imageCache);
+    assetLoader.setAssetPack(pack);
+    int backgroundAsset = assetLoader.queueImage("assets/images/background.jpg", ASSET_TEXTURE);
+    int gameBackgroundAsset = assetLoader.queueImage("assets/images/game_background.jpg", ASSET_TEXTURE);
+    std::vector<int> characterAssets;
+    for (const auto& path : characterSheets) {
+        // Texture cho màn hình chọn nhân vật, surface để đóng gói vào atlas
+        characterAssets.push_back(assetLoader.queueImage(path, ASSET_SURFACE | ASSET_TEXTURE));
+    }
+    std::vector<int> obstacleAssets;
+    for (const auto& path : ObstacleManager::texturePaths()) {
+        obstacleAssets.push_back(assetLoader.queueImage(path, ASSET_SURFACE));
+    }
+    const std::vector<std::string> soundPaths = {
+        "assets/sounds/button.mp3",
+        "assets/sounds/crash.mp3",
+        "assets/sounds/score.mp3",
+        "assets/sounds/select.mp3"
+    };
+    std::vector<int> soundAssets;
+    for (const auto& path : soundPaths) {
+        soundAssets.push_back(assetLoader.queueChunk(path));
+    }
+    assetLoader.start();
+
+    SDL_Texture* background = nullptr;
+    SDL_Texture* gameBackground = nullptr;
     CharacterSelector characterSelector;
-   if (!characterSelector.loadResources(renderer, 
-    {"assets/images/characters/Elf.png",
-     "assets/images/characters/Wizart.png", 
-     "assets/images/characters/Knight.png"},
-    "assets/sounds/select.mp3")) {
-    std::cerr << "Failed to load character resources!" << std::endl;
-        }
-
-    Button buttons[3] = {
-        {{150, 450, 200, 50}, {0, 255, 0, 255}, "Play"},
-        {{150, 520, 200, 50}, {255, 165, 0, 255}, "Guide"},
-        {{150, 590, 200, 50}, {255, 0, 0, 255}, "Settings"}
+
+    // Mỗi màn hình là một cây widget dựng một lần; bố cục chỉ được tính lại khi có gì thay đổi
+    const SDL_Color white = {255, 255, 255, 255};
+    UiContext ui = {renderer, &textRenderer, &strings, SDL_RenderTargetSupported(renderer) == SDL_TRUE};
+
+    Panel menuUi({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+    menuUi.add(std::make_unique<Label>(SDL_Rect{0, 100, SCREEN_WIDTH, 0}, titleFont, white))->setTextId("title");
+    characterSelector.buildUi(menuUi, selectFont);
+    menuUi.add(std::make_unique<Button>(SDL_Rect{150, 450, 200, 50}, font, "menu.play", UiAction::PLAY));
+    menuUi.add(std::make_unique<Button>(SDL_Rect{150, 520, 200, 50}, font, "menu.guide", UiAction::GUIDE));
+    menuUi.add(std::make_unique<Button>(SDL_Rect{150, 590, 200, 50}, font, "menu.settings", UiAction::SETTINGS));
+
+    // Bấm vào đâu trên màn hình hướng dẫn cũng quay về menu
+    Panel guideUi({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+    guideUi.setAction(UiAction::BACK);
+    guideUi.setColumn(100, 10);
+    // nullptr là dòng trống
+    const char* guideLines[] = {
+        "guide.title", "guide.mouse", "guide.avoid", "guide.score",
+        "guide.speed", "guide.pause", "guide.win", nullptr, "guide.back"
     };
+    for (const char* id : guideLines) {
+        if (!id) {
+            guideUi.add(std::make_unique<Widget>(SDL_Rect{0, 0, 0, strings.run(textRenderer, "guide.title", selectFont).height}));
+            continue;
+        }
+        guideUi.add(std::make_unique<Label>(SDL_Rect{0, 0, SCREEN_WIDTH, 0}, selectFont, white))->setTextId(id);
+    }
 
-    Button settingsMusicToggleButton;
-    Button settingsBackButton = {{(SCREEN_WIDTH - 250) / 2, 300, 250, 50}, {100, 100, 100, 255}, "Back to Menu"};
-    char musicToggleButtonText[50];
+    Panel settingsUi({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+    int settingsTitleH = strings.run(textRenderer, "settings.title", titleFont).height;
+    int settingsButtonsY = 100 + settingsTitleH + 40;
+    settingsUi.add(std::make_unique<Label>(SDL_Rect{0, 100, SCREEN_WIDTH, 0}, titleFont, white))->setTextId("settings.title");
+    Button* musicToggleButton = settingsUi.add(std::make_unique<Button>(
+        SDL_Rect{(SCREEN_WIDTH - 250) / 2, settingsButtonsY, 250, 50}, font, "settings.music_on", UiAction::TOGGLE_MUSIC));
+    settingsUi.add(std::make_unique<Button>(
+        SDL_Rect{(SCREEN_WIDTH - 250) / 2, settingsButtonsY + 100, 250, 50}, font, "settings.back", UiAction::BACK));
 
     const int PAUSE_BUTTON_WIDTH = 280;  
     const int PAUSE_BUTTON_HEIGHT = 50;  
@@ -350,22 +700,69 @@ int main(int argc, char* argv[]) {
     const int PAUSE_BUTTON_SPACING = 40;  // Khoảng cách dọc giữa các nút
     int pause_buttons_start_y = SCREEN_HEIGHT / 2 - 50;
 
-    Button pauseMenuButtons[3];
-    pauseMenuButtons[0].rect = {PAUSE_BUTTON_X_POS,pause_buttons_start_y,PAUSE_BUTTON_WIDTH,PAUSE_BUTTON_HEIGHT};
-    pauseMenuButtons[0].text = "    CONTINUE";
-    pauseMenuButtons[0].color = {50, 200, 50, 255};
+    // Màn hình pause nằm trên ảnh game đã chụp nên không có nền
+    Panel pauseUi({0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+    int pauseTitleH = strings.run(textRenderer, "pause.title", titleFont).height;
+    pauseUi.add(std::make_unique<Label>(SDL_Rect{0, pause_buttons_start_y - pauseTitleH - 40, SCREEN_WIDTH, 0}, // cách nút đầu tiên 40px
+                                        titleFont, white))->setTextId("pause.title");
+    const char* pauseButtonIds[] = {"pause.continue", "pause.resume", "pause.menu"};
+    const UiAction pauseButtonActions[] = {UiAction::CONTINUE, UiAction::RESTART, UiAction::MENU};
+    for (int i = 0; i < 3; ++i) {
+        SDL_Rect rect = {PAUSE_BUTTON_X_POS, pause_buttons_start_y + (PAUSE_BUTTON_HEIGHT + PAUSE_BUTTON_SPACING) * i,
+                         PAUSE_BUTTON_WIDTH, PAUSE_BUTTON_HEIGHT};
+        pauseUi.add(std::make_unique<Button>(rect, font, pauseButtonIds[i], pauseButtonActions[i]));
+    }
 
-    pauseMenuButtons[1].rect = {PAUSE_BUTTON_X_POS,pause_buttons_start_y + PAUSE_BUTTON_HEIGHT + PAUSE_BUTTON_SPACING,PAUSE_BUTTON_WIDTH,PAUSE_BUTTON_HEIGHT};
-    pauseMenuButtons[1].text = "RESUME";
-    pauseMenuButtons[1].color = {200, 200, 50, 255};
-    
-    pauseMenuButtons[2].rect = {PAUSE_BUTTON_X_POS,pause_buttons_start_y + (PAUSE_BUTTON_HEIGHT + PAUSE_BUTTON_SPACING) * 2,PAUSE_BUTTON_WIDTH,PAUSE_BUTTON_HEIGHT};
-    pauseMenuButtons[2].text = "BACK TO Menu";
-    pauseMenuButtons[2].color = {200, 50, 50, 255};
+    Widget* uiScreens[] = {&menuUi, &guideUi, &settingsUi, &pauseUi};
+    // Màn hình tĩnh: chỉ ghép lại texture toàn màn hình khi có widget thay đổi
+    auto drawScreen = [&](GameState state, Widget& root) {
+        if (root.needsRedraw()) screenCache.invalidate(state);
+        screenCache.draw(state, [&](SDL_Renderer*) { root.render(ui); });
+    };
 
-    GameState currentState = GameState::MENU;
+    GameState currentState = GameState::LOADING;
     Game game;
-    Uint32 lastFrameTime = SDL_GetTicks();
+
+    // Texture engine tự tạo không nằm trong bảng tài nguyên nhưng vẫn phải tính vào ngân sách và báo cáo
+    std::vector<SDL_Texture*> engineTextures;
+    auto trackEngineTextures = [&]() {
+        engineTextures.assign(1, game.spriteAtlas().texture());
+        resources.trackTextures("[sprite atlas]", engineTextures);
+        engineTextures.clear();
+        textRenderer.collectTextures(engineTextures);
+        resources.trackTextures("[glyph atlas]", engineTextures);
+        engineTextures.clear();
+        screenCache.collectTextures(engineTextures);
+        resources.trackTextures("[screen cache]", engineTextures);
+        engineTextures.clear();
+        game.backdrop().collectTextures(engineTextures);
+        resources.trackTextures("[pause backdrop]", engineTextures);
+        engineTextures.clear();
+        for (Widget* screen : uiScreens) screen->collectTextures(engineTextures);
+        resources.trackTextures("[widget cache]", engineTextures);
+    };
+    game.setJobSystem(&jobSystem);
+    game.setStrings(&strings);
+    game.setObstacleDensity(obstacleDensity);
+    if (hasSeed) game.setSeed(seed);
+
+    // Mặc định chạy theo tần số quét của màn hình đang chứa cửa sổ
+    SDL_DisplayMode displayMode;
+    int refreshRate = 0;
+    if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &displayMode) == 0) {
+        refreshRate = displayMode.refresh_rate;
+    }
+    FramePacer framePacer;
+    framePacer.setTargetFps(targetFps >= 0 ? targetFps : (refreshRate > 0 ? refreshRate : DEFAULT_TARGET_FPS));
+    framePacer.setVsync(useVsync, refreshRate);
+
+    // Mô phỏng chạy trên luồng riêng; luồng chính chỉ xử lý sự kiện và vẽ từ snapshot
+    game.publishSnapshot();
+    game.acquireSnapshot();
+    SimulationThread simThread;
+    if (!simThread.start([&game](float dt) { game.step(dt); })) {
+        std::cerr << "Failed to start simulation thread!" << std::endl;
+    }
     bool isRunning = true;
     SDL_Event event;
     bool isMusicOn = true;
@@ -380,56 +777,130 @@ int main(int argc, char* argv[]) {
             Mix_VolumeMusic(0);
             }
         }
-    std::vector<DialogueLine> victoryDialogueScript;
-    int currentVictoryDialogueLine = 0;
-
     SDL_Texture* playerPortraitVictory = nullptr; 
-    SDL_Texture* npcPortraitVictory = LoadTexture("assets/images/hdieu.png", renderer)  ;
     SDL_Texture* dialogueBoxBackground = nullptr;
-    SDL_Texture* victoryStateBackground=LoadTexture("assets/images/victory.png",renderer);
+    SDL_Texture* victoryStateBackground = nullptr;
+
+    // Hộp thoại VICTORY: vùng chữ chừa chỗ cho dòng nhắc ở góc dưới
+    const SDL_Rect dialogueBoxRect = { SCREEN_WIDTH / 10, SCREEN_HEIGHT * 2 / 3 - 20, SCREEN_WIDTH * 8 / 10, SCREEN_HEIGHT / 3 };
+    const int dialoguePromptH = strings.run(textRenderer, "victory.continue", font).height;
+    const SDL_Rect dialogueTextRect = {dialogueBoxRect.x + 20, dialogueBoxRect.y + 20, dialogueBoxRect.w - 40,
+                                       dialogueBoxRect.h - 20 - dialoguePromptH - 20};
+
+    // Kịch bản được ngắt dòng, shape và chia trang một lần ở đây
+    DialogueScript victoryScript;
+    if (!victoryScript.load("assets/dialogue/" + language + "/victory.txt", pack) && language != DEFAULT_LANGUAGE) {
+        victoryScript.load(std::string("assets/dialogue/") + DEFAULT_LANGUAGE + "/victory.txt", pack);
+    }
+    victoryScript.layout(textRenderer, font, dialogueTextRect);
+    DialoguePlayer victoryDialogue;
+
+    // Ảnh màn hình VICTORY chỉ được tải khi sắp thắng và bỏ đi khi về menu
+    StateAssets victoryAssets(resources, &jobSystem, &imageCache, pack);
+    victoryAssets.addTexture("assets/images/victory.png");
+    for (const std::string& portrait : victoryScript.portraitPaths()) {
+        victoryAssets.addTexture(portrait);
+    }
+
+    // Màn hình không có gì tự chuyển động: chờ sự kiện thay vì vẽ lại mỗi khung hình
+    auto isIdleState = [](GameState state) {
+        return state == GameState::MENU || state == GameState::GUIDE ||
+               state == GameState::SETTINGS || state == GameState::PAUSED;
+    };
+    auto idleScreen = [&](GameState state) -> Widget* {
+        switch (state) {
+            case GameState::MENU: return &menuUi;
+            case GameState::GUIDE: return &guideUi;
+            case GameState::SETTINGS: return &settingsUi;
+            case GameState::PAUSED: return &pauseUi;
+            default: return nullptr;
+        }
+    };
+    bool windowVisible = true;
+    bool forceRedraw = true;
+    GameState drawnState = currentState;
 
     while (isRunning) {
 
-        Uint32 currentFrameTime = SDL_GetTicks();
-        float deltaTime = (currentFrameTime - lastFrameTime) / 1000.0f;
-        lastFrameTime = currentFrameTime;
+        // Cửa sổ bị ẩn thì chỉ LOADING còn việc để làm (tạo texture), mọi trạng thái khác đều chờ
+        bool idle = isIdleState(currentState) || (!windowVisible && currentState != GameState::LOADING);
+        if (idle) {
+            Uint32 timeout = IDLE_WAIT_MS;
+            if (currentState == GameState::MENU && windowVisible) {
+                timeout = std::min(timeout, characterSelector.previewDelay(SDL_GetTicks()));
+            }
+            // Chỉ chờ, sự kiện vẫn nằm trong hàng đợi cho vòng SDL_PollEvent bên dưới
+            SDL_WaitEventTimeout(nullptr, static_cast<int>(timeout));
+        }
+
+        float frameDt = framePacer.beginFrame();
+        game.acquireSnapshot();
 
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT) {
                 isRunning = false;
             }
+            if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+                screenCache.invalidateAll();
+                for (Widget* screen : uiScreens) screen->invalidateAll();
+                forceRedraw = true;
+            }
+            if (event.type == SDL_WINDOWEVENT) {
+                switch (event.window.event) {
+                    case SDL_WINDOWEVENT_HIDDEN:
+                    case SDL_WINDOWEVENT_MINIMIZED:
+                        windowVisible = false;
+                        break;
+                    case SDL_WINDOWEVENT_SHOWN:
+                    case SDL_WINDOWEVENT_RESTORED:
+                    case SDL_WINDOWEVENT_EXPOSED:
+                        windowVisible = true;
+                        forceRedraw = true;
+                        break;
+                }
+            }
             switch (currentState) {
-                case GameState::MENU:
-                    if (event.type == SDL_MOUSEBUTTONDOWN) {
-                        int mouseX, mouseY;
-                        SDL_GetMouseState(&mouseX, &mouseY);
-                        
-                        characterSelector.handleEvent(&event);
-                        
-                        for (int i = 0; i < 3; i++) {
-                            if (mouseX >= buttons[i].rect.x && mouseX <= buttons[i].rect.x + buttons[i].rect.w &&
-                                mouseY >= buttons[i].rect.y && mouseY <= buttons[i].rect.y + buttons[i].rect.h) {
-                                if (buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
-                                
-                                if (i == 0) {
-                                    game.init(renderer, characterSelector.getSelectedCharacterPath(),
-                                              "assets/sounds/crash.mp3", "assets/sounds/score.mp3",gameBackground);
-                                    game.reset();
-                                    currentState = GameState::PLAYING;
-                                } else if (i == 1) {
-                                    currentState = GameState::GUIDE;
-                                } else if (i == 2) {
-                                    currentState = GameState::SETTINGS;
-                                }
-                            }
+                case GameState::LOADING:
+                    break;
+
+                case GameState::MENU: {
+                    UiAction action = menuUi.dispatch(event, ui);
+                    if (action == UiAction::PREVIOUS_CHARACTER || action == UiAction::NEXT_CHARACTER) {
+                        if (characterSelector.step(action == UiAction::PREVIOUS_CHARACTER ? -1 : 1)) {
+                            // Chuẩn bị luôn nhân vật vừa chọn để bấm Play không bị khựng
+                            SimLock lock(simThread);
+                            game.prepare(renderer, characterSelector.getSelectedCharacterPath(),
+                                         resources.chunk("assets/sounds/crash.mp3"),
+                                         resources.chunk("assets/sounds/score.mp3"), gameBackground);
                         }
+                        break;
+                    }
+                    if (action != UiAction::NONE && buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
+                    if (action == UiAction::PLAY) {
+                        // Mọi thứ đã được chuẩn bị trong menu, chỉ còn khôi phục trạng thái đầu ván
+                        SimLock lock(simThread);
+                        game.reset();
+                        currentState = GameState::PLAYING;
+                    } else if (action == UiAction::GUIDE) {
+                        currentState = GameState::GUIDE;
+                    } else if (action == UiAction::SETTINGS) {
+                        currentState = GameState::SETTINGS;
                     }
                     break;
+                }
                     
                 case GameState::PLAYING:
                     if (event.type == SDL_KEYDOWN) {
                     // Nhấn 'P' hoặc 'Escape' để Pause game
                         if (event.key.keysym.sym == SDLK_p || event.key.keysym.sym == SDLK_ESCAPE) {
+                            // Dừng mô phỏng trước khi chụp: chờ bước đang chạy dở xong rồi lấy snapshot cuối,
+                            // để ảnh pause đúng là trạng thái sẽ được tiếp tục
+                            simThread.setActive(false);
+                            {
+                                SimLock lock(simThread);
+                                game.acquireSnapshot();
+                            }
+                            game.freeze(renderer, textRenderer, font, BackdropStyle::BLUR, 120);
                             currentState = GameState::PAUSED;
                         }
                     }
@@ -438,66 +909,62 @@ int main(int argc, char* argv[]) {
                             currentState = GameState::MENU;
                         }
                     } else {
+                        SimLock lock(simThread);
                         game.handleEvent(&event);
                     }
                     break;
                 case GameState::PAUSED:
-                    if (event.type == SDL_MOUSEBUTTONDOWN) {
-                        int mouseX, mouseY;
-                        SDL_GetMouseState(&mouseX, &mouseY);
-                        SDL_Point clickPoint = {mouseX, mouseY};
-                        
-                        if (SDL_PointInRect(&clickPoint, &pauseMenuButtons[0].rect)) {
+                    switch (pauseUi.dispatch(event, ui)) {
+                        case UiAction::CONTINUE:
+                            game.unfreeze();
                             currentState = GameState::PLAYING;
-                        }
-                        
-                        else if (SDL_PointInRect(&clickPoint, &pauseMenuButtons[1].rect)) {
+                            break;
+                        case UiAction::RESTART: {
+                            SimLock lock(simThread);
                             game.reset(); // Reset lại trò chơi
                             currentState = GameState::PLAYING; // Chuyển sang trạng thái chơi
+                            break;
                         }
-                        
-                        else if (SDL_PointInRect(&clickPoint, &pauseMenuButtons[2].rect)) {
+                        case UiAction::MENU:
                             currentState = GameState::MENU;
-                        }
+                            break;
+                        default:
+                            break;
                     }
                 break;
 
                 case GameState::GUIDE:
-                case GameState::SETTINGS:
-                if (event.type == SDL_MOUSEBUTTONDOWN) {
-
-                    int mouseX, mouseY;
-                    SDL_GetMouseState(&mouseX, &mouseY);
-                    SDL_Point clickPoint = {mouseX, mouseY};
-
-                    if (currentState == GameState::SETTINGS) {
-
-                        if (SDL_PointInRect(&clickPoint, &settingsMusicToggleButton.rect)) {
-                            isMusicOn = !isMusicOn;
-                            if (isMusicOn) { Mix_VolumeMusic(musicVolumeWhenOn); }
-                            else { Mix_VolumeMusic(0); }
-                            if (buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
-                        } else if (SDL_PointInRect(&clickPoint, &settingsBackButton.rect)) {
-                            currentState = GameState::MENU; // Nút Back trong Settings đưa về MENU
-                            if (buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
-                        }
-
-                    } else {
+                    if (guideUi.dispatch(event, ui) == UiAction::BACK) {
                         currentState = GameState::MENU;
                         if (buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
                     }
-                }
                 break;
 
+                case GameState::SETTINGS: {
+                    UiAction action = settingsUi.dispatch(event, ui);
+                    if (action == UiAction::TOGGLE_MUSIC) {
+                        isMusicOn = !isMusicOn;
+                        if (isMusicOn) { Mix_VolumeMusic(musicVolumeWhenOn); }
+                        else { Mix_VolumeMusic(0); }
+                        musicToggleButton->setTextId(isMusicOn ? "settings.music_on" : "settings.music_off");
+                    } else if (action == UiAction::BACK) {
+                        currentState = GameState::MENU; // Nút Back trong Settings đưa về MENU
+                    }
+                    if (action != UiAction::NONE && buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
+                    break;
+                }
+
                 case GameState::VICTORY:
                 if (event.type == SDL_MOUSEBUTTONDOWN || 
                     (event.type == SDL_KEYDOWN && event.key.repeat == 0)) {
-                    currentVictoryDialogueLine++;
                     if (buttonSound) Mix_PlayChannel(-1, buttonSound, 0);
 
-                    if (static_cast<size_t>(currentVictoryDialogueLine) >= victoryDialogueScript.size()) {
+                    if (!victoryDialogue.advance()) {
                         currentState = GameState::MENU;
-                        game.reset();
+                        {
+                            SimLock lock(simThread);
+                            game.reset();
+                        }
                         if (isMusicOn && bgMusic) {
                              if(Mix_PlayingMusic() == 0 || Mix_PausedMusic() == 1) Mix_PlayMusic(bgMusic, -1);
                              Mix_VolumeMusic(musicVolumeWhenOn);
@@ -510,151 +977,152 @@ int main(int argc, char* argv[]) {
             }
         }
 
-        if (currentState == GameState::PLAYING && !game.gameOver()&& !game.hasWon()) {
-            game.update(deltaTime);
+        // Tạo vài texture mỗi khung hình; khi mọi thứ đã xong thì phân phát tài nguyên và vào MENU
+        if (currentState == GameState::LOADING) {
+            assetLoader.pump(renderer, ASSET_UPLOADS_PER_FRAME);
+            if (assetLoader.isDone()) {
+                // Đăng ký vào bảng tài nguyên để những lần dùng sau không đọc lại file
+                for (int id : soundAssets) {
+                    resources.addChunk(assetLoader.path(id), assetLoader.takeChunk(id));
+                }
+                // Hai nền này được dùng qua con trỏ thô suốt phiên chơi nên phải ghim
+                for (int id : {backgroundAsset, gameBackgroundAsset}) {
+                    resources.addTexture(assetLoader.path(id), assetLoader.takeTexture(id));
+                    resources.pinTexture(assetLoader.path(id));
+                }
+                background = resources.texture(assetLoader.path(backgroundAsset)).get();
+                gameBackground = resources.texture(assetLoader.path(gameBackgroundAsset)).get();
+                buttonSound = resources.chunk("assets/sounds/button.mp3").get();
+                menuUi.setBackground(background);
+                guideUi.setBackground(background);
+                settingsUi.setBackground(background);
+
+                std::vector<TextureHandle> sheets;
+                for (int id : characterAssets) {
+                    sheets.push_back(resources.addTexture(assetLoader.path(id), assetLoader.takeTexture(id)));
+                }
+                if (!characterSelector.loadResources(characterSheets, sheets, resources.chunk("assets/sounds/select.mp3"))) {
+                    std::cerr << "Failed to load character resources!" << std::endl;
+                }
+                {
+                    SimLock lock(simThread);
+                    for (int id : characterAssets) {
+                        game.addSpriteSurface(assetLoader.path(id), assetLoader.takeSurface(id));
+                    }
+                    for (int id : obstacleAssets) {
+                        game.addSpriteSurface(assetLoader.path(id), assetLoader.takeSurface(id));
+                    }
+                    if (!game.loadSprites(renderer, characterSheets)) {
+                        std::cerr << "Failed to build sprite atlas!" << std::endl;
+                    }
+                    game.prepare(renderer, characterSelector.getSelectedCharacterPath(),
+                                 resources.chunk("assets/sounds/crash.mp3"),
+                                 resources.chunk("assets/sounds/score.mp3"), gameBackground);
+                }
+                assetLoader.release();
+                currentState = GameState::MENU;
+            }
+        }
+
+        // Luồng mô phỏng chạy các bước SIM_DT cố định khi đang chơi
+        // Cửa sổ bị ẩn thì ván chơi dừng lại, không chạy tiếp khi người chơi không nhìn thấy
+        bool simActive = currentState == GameState::PLAYING && !game.gameOver() && !game.hasWon() && windowVisible;
+        simThread.setActive(simActive);
+        if (!simActive && currentState != GameState::LOADING) {
+            SimLock lock(simThread);
+            game.prepareNextRound();
+        }
+
+        if (currentState == GameState::PLAYING && !game.isStressMode() &&
+            game.currentScore() >= static_cast<int>(VICTORY_SCORE * VICTORY_PREFETCH_FRACTION)) {
+            victoryAssets.prefetch();
+        } else if (currentState == GameState::MENU && victoryAssets.isResident()) {
+            victoryAssets.evict();
+            victoryStateBackground = nullptr;
+            victoryScript.bindPortraits(victoryAssets);
         }
+        victoryAssets.pump(renderer);
+
         if (currentState == GameState::PLAYING && game.hasWon()) {
+            // Thường đã được tải trước từ lúc gần đủ điểm, khi đó không phải chờ gì
+            victoryAssets.acquire(renderer);
+            victoryStateBackground = victoryAssets.texture("assets/images/victory.png");
+            victoryScript.bindPortraits(victoryAssets);
+            victoryDialogue.start(&victoryScript);
             currentState = GameState::VICTORY;
-            currentVictoryDialogueLine = 0;
             if (bgMusic && Mix_PlayingMusic()) { // Chỉ dừng nếu nhạc đang phát
                 Mix_HaltMusic();
             }
-            victoryDialogueScript.clear();
-            victoryDialogueScript.push_back({"...", "YOU WIN"}); 
-           // victoryDialogueScript.push_back({" H Dieu", ""}); 
-            //victoryDialogueScript.push_back({"", ""});
+        }
+        if (currentState == GameState::VICTORY) {
+            victoryDialogue.update(frameDt);
+        }
+
+        // Màn hình tĩnh chỉ vẽ lại khi có input làm đổi widget, đổi trạng thái hoặc tới nhịp animation xem trước
+        Widget* screen = idleScreen(currentState);
+        bool previewDue = windowVisible && currentState == GameState::MENU && characterSelector.updatePreview(SDL_GetTicks());
+        bool redraw = windowVisible && (!isIdleState(currentState) || forceRedraw || currentState != drawnState ||
+                                        (screen && screen->needsRedraw()) || previewDue);
+        if (!redraw) {
+            if (!idle) framePacer.endFrame();
+            continue;
         }
 
         SDL_RenderClear(renderer);
 
         switch (currentState) {
-            case GameState::MENU:
-                if (background) {
-                    SDL_RenderCopy(renderer, background, NULL, NULL);
-                }
+            case GameState::LOADING: {
+                SDL_Rect bar = {(SCREEN_WIDTH - LOADING_BAR_WIDTH) / 2, SCREEN_HEIGHT / 2,
+                                LOADING_BAR_WIDTH, LOADING_BAR_HEIGHT};
+                SDL_Rect filled = bar;
+                filled.w = static_cast<int>(bar.w * assetLoader.progress());
+                SDL_SetRenderDrawColor(renderer, 60, 60, 60, 255);
+                SDL_RenderFillRect(renderer, &bar);
+                SDL_SetRenderDrawColor(renderer, 50, 200, 50, 255);
+                SDL_RenderFillRect(renderer, &filled);
+                SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+                SDL_RenderDrawRect(renderer, &bar);
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 
-                if (titleFont) {
-                    SDL_Color titleColor = {255, 255, 255, 255};
-                    SDL_Surface* titleSurface = TTF_RenderText_Solid(titleFont, "GAME VIPP", titleColor);
-                    if (titleSurface) {
-                        SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-                        if (titleTexture) {
-                            int titleX = (SCREEN_WIDTH - titleSurface->w) / 2;
-                            SDL_Rect titleRect = {titleX, 100, titleSurface->w, titleSurface->h};
-                            SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
-                            SDL_DestroyTexture(titleTexture);
-                        }
-                        SDL_FreeSurface(titleSurface);
-                    }
-                }
-                
-                characterSelector.render(renderer, selectFont);
-                
-                for (const auto& button : buttons) {
-                    DrawButton(renderer, button, font);
+                if (selectFont) {
+                    const TextRun& label = strings.run(textRenderer, "loading", selectFont);
+                    std::string percent = " " + std::to_string(static_cast<int>(assetLoader.progress() * 100)) + "%";
+                    int percentW = 0;
+                    textRenderer.measureText(selectFont, percent, &percentW, nullptr);
+                    int textX = (SCREEN_WIDTH - label.width - percentW) / 2;
+                    int textY = bar.y - label.height - 10;
+                    textRenderer.drawRun(selectFont, label, textX, textY, {255, 255, 255, 255});
+                    textRenderer.drawText(selectFont, percent, textX + label.width, textY, {255, 255, 255, 255});
                 }
                 break;
+            }
+            case GameState::MENU:
+                drawScreen(GameState::MENU, menuUi);
+                // Chỉ animation nhân vật được vẽ mỗi khung hình
+                characterSelector.renderCharacterPreview(renderer);
+                break;
                 
             case GameState::PLAYING:
             
-                game.render(renderer, font);
+                game.render(renderer, textRenderer, font);
                 break;
-            case GameState::PAUSED: {
-                game.render(renderer, font); 
-                //Lớp Phủ
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND); // Bật chế độ trộn màu
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180); // Màu đen, alpha 180 (độ mờ ~70%)
-                SDL_Rect overlayRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-                SDL_RenderFillRect(renderer, &overlayRect);
-                SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE); // Tắt chế độ trộn màu  
-                if (titleFont) {
-                    SDL_Surface* surf = TTF_RenderText_Solid(titleFont, "PAUSING", {255, 255, 255, 255});
-                    if (surf) {
-                    SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-
-                    int title_y = pauseMenuButtons[0].rect.y - surf->h - 40; // cách nút đầu tiên 40px
-        
-                    SDL_Rect titleRect = {(SCREEN_WIDTH - surf->w) / 2, title_y, surf->w, surf->h};
-                    SDL_RenderCopy(renderer, tex, NULL, &titleRect);
-                    SDL_DestroyTexture(tex);
-                    SDL_FreeSurface(surf);
-                    }
-                }
-                for (int i = 0; i < 3; ++i) {
-                    DrawButton(renderer, pauseMenuButtons[i], font);
-                }
+            case GameState::PAUSED:
+                // Nền đã được chụp, làm mờ và làm tối một lần khi bắt đầu pause; chữ và nút là texture đã vẽ sẵn
+                game.renderFrozen(renderer, textRenderer, font);
+                pauseUi.render(ui);
                 break;
-            }
             case GameState::GUIDE:
-                if (background) {
-                    SDL_RenderCopy(renderer, background, NULL, NULL);
-                }
-                
-                if (selectFont) {
-                    SDL_Color textColor = {255, 255, 255, 255};
-                    const char* lines[] = {
-                        "HOW TO PLAY:",
-                        "- Move your mouse to control the character",
-                        "- Avoid the obstacles coming from above",
-                        "- Each obstacle you pass gives you 1 point",
-                        "- The game gets faster as you score more",
-                        "- Press P or ESC to pause game",
-                        "- You win when you reach 1000 points",
-                        "",
-                        "Click to return to menu"
-                    };
-                    
-                    int y = 100;
-                    for (const char* line : lines) {
-                        SDL_Surface* textSurface = TTF_RenderText_Solid(selectFont, line, textColor);
-                        if (textSurface) {
-                            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-                            if (textTexture) {
-                                int x = (SCREEN_WIDTH - textSurface->w) / 2;
-                                SDL_Rect textRect = {x, y, textSurface->w, textSurface->h};
-                                SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-                                SDL_DestroyTexture(textTexture);
-                                y += textSurface->h + 10;
-                            }
-                            SDL_FreeSurface(textSurface);
-                        }
-                    }
-                }
+                drawScreen(GameState::GUIDE, guideUi);
                 break;
                 
             case GameState::SETTINGS:
-                if (background) {
-                    SDL_RenderCopy(renderer, background, NULL, NULL);
-                }
-                
-                if (selectFont) {
-                    SDL_Color textColor = {255, 255, 255, 255};
-                    
-                    int y = 100;
-                    SDL_Surface* surf = TTF_RenderText_Solid(titleFont, "SETTINGS", textColor);
-                    if (surf) {
-                        SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-                        SDL_Rect dst = {(SCREEN_WIDTH - surf->w) / 2, y, surf->w, surf->h};
-                        SDL_RenderCopy(renderer, tex, NULL, &dst);
-                        y += surf->h + 40; // Tăng khoảng cách Y
-                        SDL_FreeSurface(surf);
-                        SDL_DestroyTexture(tex);
-                    }
-                    sprintf(musicToggleButtonText, "Music: [ %s ]", (isMusicOn ? "ON" : "OFF"));
-                    settingsMusicToggleButton.text = musicToggleButtonText;
-                    settingsMusicToggleButton.rect = {(SCREEN_WIDTH - 250) / 2, y, 250, 50};
-                    DrawButton(renderer, settingsMusicToggleButton, font);
-                    settingsBackButton.rect.x = (SCREEN_WIDTH - settingsBackButton.rect.w) / 2; // Căn giữa X
-                    settingsBackButton.rect.y = y+100; // Đặt ở vị trí Y mới
-                    DrawButton(renderer, settingsBackButton, font); // Vẽ nút Back
-                }
+                drawScreen(GameState::SETTINGS, settingsUi);
                 break;
             case GameState::VICTORY: { 
             if (victoryStateBackground) { 
                 SDL_RenderCopy(renderer, victoryStateBackground, NULL, NULL);
             } 
             // Vẽ hộp thoại
-            SDL_Rect dialogueBoxRect = { SCREEN_WIDTH / 10, SCREEN_HEIGHT * 2 / 3 - 20, SCREEN_WIDTH * 8 / 10, SCREEN_HEIGHT / 3 };
             SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
             SDL_SetRenderDrawColor(renderer, 10, 10, 30, 220);
             SDL_RenderFillRect(renderer, &dialogueBoxRect);
@@ -662,87 +1130,73 @@ int main(int argc, char* argv[]) {
             SDL_RenderDrawRect(renderer, &dialogueBoxRect);
             SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
-             if (npcPortraitVictory && static_cast<size_t>(currentVictoryDialogueLine) < victoryDialogueScript.size()) {
-                 const DialogueLine& currentLine = victoryDialogueScript[currentVictoryDialogueLine];
-                 if (currentLine.speakerName == "PRINCESS") { 
-                      SDL_Rect portraitDestRect = {dialogueBoxRect.x + dialogueBoxRect.w - 150 - 10, dialogueBoxRect.y - 160, 150, 150};
-                      SDL_RenderCopy(renderer, npcPortraitVictory, NULL, &portraitDestRect);
-                 }
-             }
-
-
-            if (font && static_cast<size_t>(currentVictoryDialogueLine) < victoryDialogueScript.size()) {
-                const DialogueLine& currentLine = victoryDialogueScript[currentVictoryDialogueLine];
-                SDL_Color speakerNameColor = {255, 223, 0, 255}; 
-                SDL_Color dialogueTextColor = {255, 255, 255, 255};    
-
-                int textX = dialogueBoxRect.x + 20;
-                int currentTextY = dialogueBoxRect.y + 20;
-
-                if (!currentLine.speakerName.empty()) {
-                    std::string speakerText = currentLine.speakerName + ":";
-                    SDL_Surface* speakerSurf = TTF_RenderText_Solid(font, speakerText.c_str(), speakerNameColor);
-                    if (speakerSurf) {
-                        SDL_Texture* speakerTex = SDL_CreateTextureFromSurface(renderer, speakerSurf);
-                        SDL_Rect speakerRect = {textX, currentTextY, speakerSurf->w, speakerSurf->h};
-                        SDL_RenderCopy(renderer, speakerTex, NULL, &speakerRect);
-                        SDL_DestroyTexture(speakerTex);
-                        SDL_FreeSurface(speakerSurf);
-                        currentTextY += speakerRect.h + 8; 
-                    }
-                }
+            if (font && !victoryDialogue.isFinished()) {
+                victoryDialogue.render(renderer, textRenderer, font, dialogueBoxRect);
 
-                SDL_Surface* lineSurf = TTF_RenderText_Solid_Wrapped(font, currentLine.text.c_str(), dialogueTextColor, dialogueBoxRect.w - 40);
-                if (lineSurf) {
-                    SDL_Texture* lineTex = SDL_CreateTextureFromSurface(renderer, lineSurf);
-                    SDL_Rect lineRect = {textX, currentTextY, lineSurf->w, lineSurf->h};
-                    SDL_RenderCopy(renderer, lineTex, NULL, &lineRect);
-                    SDL_DestroyTexture(lineTex);
-                    SDL_FreeSurface(lineSurf);
+                // Chỉ nhắc bấm tiếp khi trang đã hiện hết
+                if (victoryDialogue.isPageComplete()) {
+                    const TextRun& prompt = strings.run(textRenderer, "victory.continue", font);
+                    textRenderer.drawRun(font, prompt,
+                                         dialogueBoxRect.x + dialogueBoxRect.w - prompt.width - 15,
+                                         dialogueBoxRect.y + dialogueBoxRect.h - prompt.height - 10,
+                                         {180, 180, 180, 255});
                 }
 
-                std::string promptText = "Nhan de tiep tuc...";
-                SDL_Surface* promptSurf = TTF_RenderText_Solid(font, promptText.c_str(), {180, 180, 180, 255}); 
-                if(promptSurf){
-                    SDL_Texture* promptTex = SDL_CreateTextureFromSurface(renderer, promptSurf);
-                    SDL_Rect promptDst = {
-                        dialogueBoxRect.x + dialogueBoxRect.w - promptSurf->w - 15, 
-                        dialogueBoxRect.y + dialogueBoxRect.h - promptSurf->h - 10, 
-                        promptSurf->w, promptSurf->h
-                    };
-                    SDL_RenderCopy(renderer, promptTex, NULL, &promptDst);
-                    SDL_DestroyTexture(promptTex);
-                    SDL_FreeSurface(promptSurf);
-                }
-
-            } else if (font && static_cast<size_t>(currentVictoryDialogueLine) >= victoryDialogueScript.size()) {
-                SDL_Surface* surf = TTF_RenderText_Solid(font, "Nhan de ve Menu", {255,255,255,255});
-                if (surf) {
-                    SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
-                    SDL_Rect dst = {(SCREEN_WIDTH - surf->w) / 2, SCREEN_HEIGHT / 2, surf->w, surf->h};
-                    SDL_RenderCopy(renderer, tex, NULL, &dst);
-                    SDL_DestroyTexture(tex);
-                    SDL_FreeSurface(surf);
-                }
+            } else if (font) {
+                const TextRun& backText = strings.run(textRenderer, "victory.menu", font);
+                textRenderer.drawRun(font, backText, (SCREEN_WIDTH - backText.width) / 2, SCREEN_HEIGHT / 2, {255,255,255,255});
             }
             break;
         }
         }
         
         SDL_RenderPresent(renderer);
-        SDL_Delay(16);
-    }
-    if (victoryStateBackground) SDL_DestroyTexture(victoryStateBackground);
-    if (npcPortraitVictory) SDL_DestroyTexture(npcPortraitVictory);
-    if (background) SDL_DestroyTexture(background);
-    if (gameBackground) SDL_DestroyTexture(gameBackground);
-    if (font) TTF_CloseFont(font);
-    if (titleFont) TTF_CloseFont(titleFont);
-    if (selectFont) TTF_CloseFont(selectFont);
-    if (bgMusic) Mix_FreeMusic(bgMusic);
-    if (buttonSound) Mix_FreeChunk(buttonSound);
-    if (crashSound) Mix_FreeChunk(crashSound);
-    if (scoreSound) Mix_FreeChunk(scoreSound);
+        trackEngineTextures();
+        drawnState = currentState;
+        forceRedraw = false;
+        // Khung hình của màn hình tĩnh không theo nhịp FramePacer và không tính vào thống kê
+        if (idle) continue;
+        framePacer.endFrame();
+
+        if (printFrameStats && framePacer.frameCount() % FRAME_STATS_INTERVAL == 0) {
+            FrameStats stats = framePacer.stats();
+            std::cout << "Frame: avg " << stats.averageMs << "ms, min " << stats.minMs
+                      << "ms, max " << stats.maxMs << "ms, p99 " << stats.p99Ms
+                      << "ms, work " << stats.workMs << "ms" << std::endl;
+        }
+    }
+    simThread.stop();
+    victoryAssets.evict();
+    assetLoader.release();
+    jobSystem.shutdown();
+    game.release();
+    characterSelector.release();
+    for (Widget* screen : uiScreens) screen->releaseCache();
+    screenCache.release();
+    textRenderer.release();
+    uiFont.release();
+    ResourceStats resourceStats = resources.stats();
+    std::cout << "Resources: " << resourceStats.hits << " hits, " << resourceStats.misses << " misses ("
+              << resourceStats.textures << " textures, " << resourceStats.chunks << " chunks, "
+              << resourceStats.music << " music, " << resourceStats.fonts << " fonts)" << std::endl;
+    std::cout << "Texture memory: " << resourceStats.textureBytes / 1024 << " KB ("
+              << resourceStats.engineTextureBytes / 1024 << " KB engine-owned)";
+    if (resourceStats.textureBudget > 0) std::cout << " of " << resourceStats.textureBudget / 1024 << " KB budget";
+    std::cout << ", " << resourceStats.evictions << " evictions" << std::endl;
+    if (imageCache.isEnabled()) {
+        std::cout << "Image cache: " << imageCache.hits() << " hits, " << imageCache.misses() << " misses" << std::endl;
+    }
+    if (printTextureReport) {
+        for (const TextureUsage& usage : resources.textureUsage()) {
+            std::cout << "  " << usage.path << " " << usage.width << "x" << usage.height << " " << usage.bytes / 1024 << " KB, ";
+            if (usage.engine) {
+                std::cout << usage.count << (usage.count == 1 ? " texture" : " textures") << ", engine-owned" << std::endl;
+            } else {
+                std::cout << usage.refs << " refs" << (usage.pinned ? ", pinned" : "") << std::endl;
+            }
+        }
+    }
+    resources.release();
     Mix_CloseAudio();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
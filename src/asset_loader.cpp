@@ -0,0 +1,176 @@
+#include "asset_loader.h"
+#include <SDL_image.h>
+#include <iostream>
+
+AssetLoader::AssetLoader() : m_jobSystem(nullptr), m_imageCache(nullptr), m_pack(nullptr), m_readyCount(0), m_started(false) {}
+
+AssetLoader::~AssetLoader() {
+    release();
+}
+
+void AssetLoader::setJobSystem(JobSystem* jobs) {
+    m_jobSystem = jobs;
+}
+
+void AssetLoader::setImageCache(ImageCache* cache) {
+    m_imageCache = cache;
+}
+
+void AssetLoader::setAssetPack(const AssetPack* pack) {
+    m_pack = pack;
+}
+
+SDL_RWops* AssetLoader::openRW(const std::string& path) const {
+    return m_pack ? m_pack->openRW(path) : SDL_RWFromFile(path.c_str(), "rb");
+}
+
+int AssetLoader::queueImage(const std::string& path, unsigned flags) {
+    return queue(path, false, flags);
+}
+
+int AssetLoader::queueChunk(const std::string& path) {
+    return queue(path, true, 0);
+}
+
+int AssetLoader::queue(const std::string& path, bool isSound, unsigned flags) {
+    if (m_started) {
+        std::cerr << "AssetLoader::queue - Loading already started, ignoring " << path << std::endl;
+        return -1;
+    }
+    std::unique_ptr<Entry> entry(new Entry());
+    entry->path = path;
+    entry->isSound = isSound;
+    entry->flags = flags;
+    entry->surface = nullptr;
+    entry->texture = nullptr;
+    entry->chunk = nullptr;
+    entry->state = QUEUED;
+    m_entries.push_back(std::move(entry));
+    return static_cast<int>(m_entries.size()) - 1;
+}
+
+void AssetLoader::start() {
+    if (m_started) return;
+    m_started = true;
+    m_jobs.reserve(m_entries.size());
+    for (auto& entry : m_entries) {
+        Entry* target = entry.get();
+        if (m_jobSystem) {
+            m_jobs.push_back(m_jobSystem->submit([this, target]() { decode(*target); }));
+        } else {
+            decode(*target);
+        }
+    }
+}
+
+// Chạy trên worker: chỉ giải mã vào bộ nhớ, không đụng tới renderer
+void AssetLoader::decode(Entry& entry) {
+    if (entry.isSound) {
+        entry.chunk = Mix_LoadWAV_RW(openRW(entry.path), 1);
+        if (!entry.chunk) {
+            std::cerr << "AssetLoader - Failed to load sound: " << entry.path << " - " << Mix_GetError() << std::endl;
+        }
+    } else {
+        entry.surface = m_imageCache ? m_imageCache->loadImage(entry.path, m_pack)
+                                     : IMG_Load_RW(openRW(entry.path), 1);
+        if (!entry.surface) {
+            std::cerr << "AssetLoader - Failed to load image: " << entry.path << " - " << IMG_GetError() << std::endl;
+        }
+    }
+
+    // Ảnh cần texture phải chờ luồng vẽ, còn lại là xong
+    if (entry.surface && (entry.flags & ASSET_TEXTURE)) {
+        entry.state.store(DECODED, std::memory_order_release);
+    } else {
+        entry.state.store(READY, std::memory_order_release);
+        m_readyCount.fetch_add(1);
+    }
+}
+
+void AssetLoader::pump(SDL_Renderer* renderer, int maxUploads) {
+    int uploads = 0;
+    for (auto& entry : m_entries) {
+        if (uploads >= maxUploads) break;
+        if (entry->state.load(std::memory_order_acquire) != DECODED) continue;
+
+        entry->texture = SDL_CreateTextureFromSurface(renderer, entry->surface);
+        if (!entry->texture) {
+            std::cerr << "AssetLoader - Failed to create texture: " << entry->path << " - " << SDL_GetError() << std::endl;
+        }
+        if (!(entry->flags & ASSET_SURFACE)) {
+            SDL_FreeSurface(entry->surface);
+            entry->surface = nullptr;
+        }
+        entry->state.store(READY, std::memory_order_release);
+        m_readyCount.fetch_add(1);
+        ++uploads;
+    }
+}
+
+void AssetLoader::finish(SDL_Renderer* renderer) {
+    start();
+    waitJobs();
+    pump(renderer, static_cast<int>(m_entries.size()));
+}
+
+void AssetLoader::waitJobs() {
+    if (m_jobSystem) {
+        for (const JobHandle& job : m_jobs) {
+            m_jobSystem->wait(job);
+        }
+    }
+    m_jobs.clear();
+}
+
+float AssetLoader::progress() const {
+    if (m_entries.empty()) return 1.0f;
+    return static_cast<float>(m_readyCount.load()) / m_entries.size();
+}
+
+bool AssetLoader::isDone() const {
+    return m_started && m_readyCount.load() == static_cast<int>(m_entries.size());
+}
+
+const std::string& AssetLoader::path(int id) const {
+    return m_entries[static_cast<size_t>(id)]->path;
+}
+
+SDL_Surface* AssetLoader::takeSurface(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= m_entries.size()) return nullptr;
+    Entry& entry = *m_entries[id];
+    if (entry.state.load(std::memory_order_acquire) != READY) return nullptr;
+    SDL_Surface* surface = entry.surface;
+    entry.surface = nullptr;
+    return surface;
+}
+
+SDL_Texture* AssetLoader::takeTexture(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= m_entries.size()) return nullptr;
+    Entry& entry = *m_entries[id];
+    if (entry.state.load(std::memory_order_acquire) != READY) return nullptr;
+    SDL_Texture* texture = entry.texture;
+    entry.texture = nullptr;
+    return texture;
+}
+
+Mix_Chunk* AssetLoader::takeChunk(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= m_entries.size()) return nullptr;
+    Entry& entry = *m_entries[id];
+    if (entry.state.load(std::memory_order_acquire) != READY) return nullptr;
+    Mix_Chunk* chunk = entry.chunk;
+    entry.chunk = nullptr;
+    return chunk;
+}
+
+void AssetLoader::release() {
+    // Không giải phóng khi worker còn đang ghi vào entry
+    waitJobs();
+    for (auto& entry : m_entries) {
+        if (entry->surface) SDL_FreeSurface(entry->surface);
+        if (entry->texture) SDL_DestroyTexture(entry->texture);
+        if (entry->chunk) Mix_FreeChunk(entry->chunk);
+    }
+    m_entries.clear();
+    m_readyCount = 0;
+    m_started = false;
+}
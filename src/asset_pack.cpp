@@ -0,0 +1,73 @@
+#include "asset_pack.h"
+#include "pack_format.h"
+#include <cstring>
+#include <iostream>
+
+AssetPack::AssetPack() {}
+
+bool AssetPack::open(const std::string& path) {
+    close();
+    if (!m_file.open(path)) return false;
+
+    const Uint8* base = m_file.data();
+    const size_t size = m_file.size();
+    PackHeader header;
+    if (size < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+    if (header.magic != PACK_MAGIC || header.version != PACK_VERSION) {
+        std::cerr << "AssetPack::open - Not a supported pack: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    uint64_t offset = sizeof(header);
+    for (uint32_t i = 0; i < header.count; ++i) {
+        PackEntry entry;
+        if (offset + sizeof(entry) > size) break;
+        std::memcpy(&entry, base + offset, sizeof(entry));
+        offset += sizeof(entry);
+        if (offset + entry.pathLength > size || entry.offset + entry.size > size) break;
+        std::string name(reinterpret_cast<const char*>(base + offset), entry.pathLength);
+        offset = PackAlign(offset + entry.pathLength);
+        m_index[name] = {base + entry.offset, static_cast<size_t>(entry.size), static_cast<Sint64>(entry.mtime)};
+    }
+    if (m_index.size() != header.count) {
+        std::cerr << "AssetPack::open - Truncated index in " << path << std::endl;
+        close();
+        return false;
+    }
+    std::cout << "AssetPack::open - Mapped " << m_index.size() << " assets from " << path << std::endl;
+    return true;
+}
+
+void AssetPack::close() {
+    m_index.clear();
+    m_file.close();
+}
+
+bool AssetPack::isOpen() const {
+    return m_file.isOpen();
+}
+
+size_t AssetPack::count() const {
+    return m_index.size();
+}
+
+bool AssetPack::find(const std::string& path, PackedAsset* out) const {
+    if (m_index.empty()) return false;
+    auto it = m_index.find(NormalizeAssetPath(path));
+    if (it == m_index.end()) return false;
+    if (out) *out = it->second;
+    return true;
+}
+
+SDL_RWops* AssetPack::openRW(const std::string& path) const {
+    PackedAsset asset;
+    if (find(path, &asset)) {
+        return SDL_RWFromConstMem(asset.data, static_cast<int>(asset.size));
+    }
+    return SDL_RWFromFile(path.c_str(), "rb");
+}
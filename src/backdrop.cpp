@@ -0,0 +1,228 @@
+#include "backdrop.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BACKDROP_USE_SSE2 1
+#endif
+
+namespace {
+const int BLUR_RADIUS = 4;
+const int BLUR_PASSES = 3;
+
+#if BACKDROP_USE_SSE2
+// Tách một pixel ARGB thành 4 kênh int32
+inline __m128i unpackPixel(Uint32 p) {
+    __m128i v = _mm_cvtsi32_si128(static_cast<int>(p));
+    v = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+    return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+
+inline Uint32 packPixel(__m128i sum, __m128 scale) {
+    __m128i v = _mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), scale));
+    v = _mm_packs_epi32(v, v);
+    v = _mm_packus_epi16(v, v);
+    return static_cast<Uint32>(_mm_cvtsi128_si32(v));
+}
+
+// Lượt ngang: cửa sổ trượt, 4 kênh của một pixel được cộng song song
+void blurRow(const Uint32* src, Uint32* dst, int width, int radius) {
+    const __m128 scale = _mm_set1_ps(1.0f / (2 * radius + 1));
+    __m128i sum = _mm_setzero_si128();
+    for (int k = -radius; k <= radius; ++k) {
+        sum = _mm_add_epi32(sum, unpackPixel(src[std::min(std::max(k, 0), width - 1)]));
+    }
+    for (int x = 0; x < width; ++x) {
+        dst[x] = packPixel(sum, scale);
+        int addX = std::min(x + radius + 1, width - 1);
+        int subX = std::max(x - radius, 0);
+        sum = _mm_add_epi32(sum, unpackPixel(src[addX]));
+        sum = _mm_sub_epi32(sum, unpackPixel(src[subX]));
+    }
+}
+
+// Lượt dọc: mỗi lần xử lý 4 pixel liền nhau trên cùng một hàng (16 kênh)
+void blurColumns(const Uint32* src, Uint32* dst, int width, int height, int radius, std::vector<Sint32>& sums) {
+    const __m128 scale = _mm_set1_ps(1.0f / (2 * radius + 1));
+    const __m128i zero = _mm_setzero_si128();
+    sums.assign(static_cast<size_t>(width) * 4, 0);
+    __m128i* acc = reinterpret_cast<__m128i*>(sums.data());
+
+    auto accumulate = [&](const Uint32* row, bool add) {
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            __m128i lo = _mm_unpacklo_epi8(px, zero);
+            __m128i hi = _mm_unpackhi_epi8(px, zero);
+            __m128i p[4] = {
+                _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)
+            };
+            for (int k = 0; k < 4; ++k) {
+                __m128i s = _mm_loadu_si128(acc + x + k);
+                s = add ? _mm_add_epi32(s, p[k]) : _mm_sub_epi32(s, p[k]);
+                _mm_storeu_si128(acc + x + k, s);
+            }
+        }
+        for (; x < width; ++x) {
+            __m128i s = _mm_loadu_si128(acc + x);
+            s = add ? _mm_add_epi32(s, unpackPixel(row[x])) : _mm_sub_epi32(s, unpackPixel(row[x]));
+            _mm_storeu_si128(acc + x, s);
+        }
+    };
+
+    for (int k = -radius; k <= radius; ++k) {
+        accumulate(src + std::min(std::max(k, 0), height - 1) * width, true);
+    }
+    for (int y = 0; y < height; ++y) {
+        Uint32* out = dst + y * width;
+        for (int x = 0; x < width; ++x) {
+            out[x] = packPixel(_mm_loadu_si128(acc + x), scale);
+        }
+        accumulate(src + std::min(y + radius + 1, height - 1) * width, true);
+        accumulate(src + std::max(y - radius, 0) * width, false);
+    }
+}
+#else
+void blurRow(const Uint32* src, Uint32* dst, int width, int radius) {
+    const int window = 2 * radius + 1;
+    int sum[4] = {0, 0, 0, 0};
+    for (int k = -radius; k <= radius; ++k) {
+        Uint32 p = src[std::min(std::max(k, 0), width - 1)];
+        for (int c = 0; c < 4; ++c) sum[c] += (p >> (c * 8)) & 0xFF;
+    }
+    for (int x = 0; x < width; ++x) {
+        Uint32 out = 0;
+        for (int c = 0; c < 4; ++c) out |= static_cast<Uint32>((sum[c] + window / 2) / window) << (c * 8);
+        dst[x] = out;
+        Uint32 add = src[std::min(x + radius + 1, width - 1)];
+        Uint32 sub = src[std::max(x - radius, 0)];
+        for (int c = 0; c < 4; ++c) sum[c] += static_cast<int>((add >> (c * 8)) & 0xFF) - static_cast<int>((sub >> (c * 8)) & 0xFF);
+    }
+}
+
+void blurColumns(const Uint32* src, Uint32* dst, int width, int height, int radius, std::vector<Sint32>& sums) {
+    const int window = 2 * radius + 1;
+    sums.assign(static_cast<size_t>(width) * 4, 0);
+    auto accumulate = [&](const Uint32* row, int sign) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 4; ++c) sums[x * 4 + c] += sign * static_cast<int>((row[x] >> (c * 8)) & 0xFF);
+        }
+    };
+    for (int k = -radius; k <= radius; ++k) {
+        accumulate(src + std::min(std::max(k, 0), height - 1) * width, 1);
+    }
+    for (int y = 0; y < height; ++y) {
+        Uint32* out = dst + y * width;
+        for (int x = 0; x < width; ++x) {
+            Uint32 p = 0;
+            for (int c = 0; c < 4; ++c) p |= static_cast<Uint32>((sums[x * 4 + c] + window / 2) / window) << (c * 8);
+            out[x] = p;
+        }
+        accumulate(src + std::min(y + radius + 1, height - 1) * width, 1);
+        accumulate(src + std::max(y - radius, 0) * width, -1);
+    }
+}
+#endif
+}
+
+void BoxBlurARGB(Uint32* pixels, int width, int height, int radius, int passes) {
+    if (!pixels || width <= 0 || height <= 0 || radius <= 0) return;
+    std::vector<Uint32> scratch(static_cast<size_t>(width) * height);
+    std::vector<Sint32> sums;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (int y = 0; y < height; ++y) {
+            blurRow(pixels + y * width, scratch.data() + y * width, width, radius);
+        }
+        blurColumns(scratch.data(), pixels, width, height, radius, sums);
+    }
+}
+
+FrozenBackdrop::FrozenBackdrop() : m_target(nullptr), m_blurred(nullptr), m_pixels(nullptr), m_captured(false) {}
+
+FrozenBackdrop::~FrozenBackdrop() {
+    release();
+}
+
+void FrozenBackdrop::release() {
+    if (m_target) SDL_DestroyTexture(m_target);
+    if (m_blurred) SDL_DestroyTexture(m_blurred);
+    delete[] m_pixels;
+    m_target = nullptr;
+    m_blurred = nullptr;
+    m_pixels = nullptr;
+    m_captured = false;
+}
+
+bool FrozenBackdrop::ensureTextures(SDL_Renderer* renderer) {
+    if (m_target) return true;
+    if (SDL_RenderTargetSupported(renderer) != SDL_TRUE) return false;
+
+    m_target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!m_target) {
+        std::cerr << "FrozenBackdrop - Failed to create target texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(m_target, SDL_BLENDMODE_NONE);
+    return true;
+}
+
+bool FrozenBackdrop::capture(SDL_Renderer* renderer, const std::function<void(SDL_Renderer*)>& drawScene,
+                             BackdropStyle style, Uint8 dimAlpha) {
+    m_captured = false;
+    if (!ensureTextures(renderer)) return false;
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    SDL_SetRenderTarget(renderer, m_target);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+    drawScene(renderer);
+
+    // Kết quả làm mờ được chép ngược lại vào target, sau đó phủ lớp tối lên cả hai kiểu
+    if (style == BackdropStyle::BLUR && applyBlur(renderer)) {
+        SDL_RenderCopy(renderer, m_blurred, NULL, NULL);
+    }
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, dimAlpha);
+    SDL_RenderFillRect(renderer, NULL);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    m_captured = true;
+    return true;
+}
+
+bool FrozenBackdrop::applyBlur(SDL_Renderer* renderer) {
+    if (!m_pixels) m_pixels = new Uint32[SCREEN_WIDTH * SCREEN_HEIGHT];
+    if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, m_pixels, SCREEN_WIDTH * 4) != 0) {
+        std::cerr << "FrozenBackdrop - Failed to read back frame: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    BoxBlurARGB(m_pixels, SCREEN_WIDTH, SCREEN_HEIGHT, BLUR_RADIUS, BLUR_PASSES);
+
+    if (!m_blurred) {
+        m_blurred = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!m_blurred) return false;
+        SDL_SetTextureBlendMode(m_blurred, SDL_BLENDMODE_NONE);
+    }
+    SDL_UpdateTexture(m_blurred, NULL, m_pixels, SCREEN_WIDTH * 4);
+    return true;
+}
+
+void FrozenBackdrop::render(SDL_Renderer* renderer) const {
+    if (m_captured) SDL_RenderCopy(renderer, m_target, NULL, NULL);
+}
+
+void FrozenBackdrop::invalidate() {
+    m_captured = false;
+}
+
+bool FrozenBackdrop::isCaptured() const {
+    return m_captured;
+}
+
+void FrozenBackdrop::collectTextures(std::vector<SDL_Texture*>& out) const {
+    if (m_target) out.push_back(m_target);
+    if (m_blurred) out.push_back(m_blurred);
+}
@@ -2,7 +2,7 @@
 #include <iostream>
 
 Background::Background()
-    : texture(nullptr), scrollY(0.0f), scrollSpeed(50.0f), textureWidth(0), textureHeight(0) {}
+    : texture(nullptr), scrollY(0.0f), prevScrollY(0.0f), scrollSpeed(50.0f), textureWidth(0), textureHeight(0) {}
 
 void Background::setTexture(SDL_Texture* tex) {
     texture = tex;
@@ -11,25 +11,36 @@ void Background::setTexture(SDL_Texture* tex) {
         SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
     }
     scrollY = 0.0f; // Reset vị trí cuộn mỗi khi có texture mới
+    prevScrollY = 0.0f;
 }
 void Background::setScrollSpeed(float speed) {
     scrollSpeed = speed;
 }
 void Background::update(float deltaTime) {
+    prevScrollY = scrollY;
     scrollY += scrollSpeed * deltaTime;
 
     while (scrollY >= static_cast<float>(textureHeight)) {
         scrollY -= static_cast<float>(textureHeight);
     }
 }
-void Background::render(SDL_Renderer* renderer) {
-    SDL_Rect destRect1 = {0, static_cast<int>(scrollY), SCREEN_WIDTH, textureHeight};
-    SDL_RenderCopy(renderer, texture, NULL, &destRect1);
+void Background::render(SDL_Renderer* renderer, float alpha) const {
+    // Nếu vừa quay vòng thì nội suy tiếp từ vị trí cũ như chưa quay vòng
+    float current = scrollY;
+    if (current < prevScrollY) current += static_cast<float>(textureHeight);
+    float y = prevScrollY + (current - prevScrollY) * alpha;
+    if (y >= static_cast<float>(textureHeight)) y -= static_cast<float>(textureHeight);
 
-    SDL_Rect destRect2 = {0, static_cast<int>(scrollY) - textureHeight, SCREEN_WIDTH, textureHeight};
-    SDL_RenderCopy(renderer, texture, NULL, &destRect2);
+    // Vẽ bằng toạ độ float để cuộn mượt dưới mức pixel
+    const float height = static_cast<float>(textureHeight);
+    SDL_FRect destRect1 = {0.0f, y, static_cast<float>(SCREEN_WIDTH), height};
+    SDL_RenderCopyF(renderer, texture, NULL, &destRect1);
+
+    SDL_FRect destRect2 = {0.0f, y - height, static_cast<float>(SCREEN_WIDTH), height};
+    SDL_RenderCopyF(renderer, texture, NULL, &destRect2);
 }
 void Background::reset() {
     scrollY = 0.0f;
+    prevScrollY = 0.0f;
 }
 
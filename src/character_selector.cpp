@@ -2,158 +2,91 @@
 #include <SDL_image.h>
 #include <iostream>
 
-bool CharacterSelector::loadResources(SDL_Renderer* renderer, const std::vector<std::string>& paths, const std::string& soundPath) {
-    selectSound = Mix_LoadWAV(soundPath.c_str());
+bool CharacterSelector::loadResources(const std::vector<std::string>& paths, const std::vector<TextureHandle>& sheets, ChunkHandle sound) {
+    selectSound = sound;
     if (!selectSound) {
-        std::cerr << "Failed to load select sound: " << Mix_GetError() << std::endl;
+        std::cerr << "Failed to load select sound" << std::endl;
     }
 
-    // Load character textures
-    for (const auto& path : paths) {
-        SDL_Surface* surface = IMG_Load(path.c_str());
-        if (!surface) {
-            std::cerr << "Failed to load image: " << path << " - " << IMG_GetError() << std::endl;
-            continue;
-        }
-        
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
-        
-        if (texture) {
-            characterTextures.push_back(texture);
-            characterPaths.push_back(path);
+    // Chỉ giữ những nhân vật có sprite sheet
+    std::vector<TextureHandle> costumes;
+    for (size_t i = 0; i < paths.size() && i < sheets.size(); ++i) {
+        if (sheets[i]) {
+            costumes.push_back(sheets[i]);
+            characterPaths.push_back(paths[i]);
         }
     }
-
-    std::vector<std::string> characters = {
-        "assets/images/characters/Elf.png",
-        "assets/images/characters/Wizart.png",
-        "assets/images/characters/knight.png"
-    };
-    character.loadCostumes(renderer, characters);
+    character.setCostumes(costumes);
     character.setPosition(characterRect.x, characterRect.y);
     character.setSize(characterRect.w, characterRect.h);
 
-    return !characterTextures.empty();
-}
-
-void CharacterSelector::handleEvent(SDL_Event* e) {
-    if (e->type == SDL_MOUSEBUTTONDOWN) {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
-        
-        if (x >= leftArrowRect.x && x <= leftArrowRect.x + leftArrowRect.w &&
-            y >= leftArrowRect.y && y <= leftArrowRect.y + leftArrowRect.h) {
-            selectedIndex = (selectedIndex - 1 + characterTextures.size()) % characterTextures.size();
-            character.prevCostume(); // Chuyển trang phục trước đó
-            if (selectSound) Mix_PlayChannel(-1, selectSound, 0);
-        }
-        else if (x >= rightArrowRect.x && x <= rightArrowRect.x + rightArrowRect.w &&
-                 y >= rightArrowRect.y && y <= rightArrowRect.y + rightArrowRect.h) {
-            selectedIndex = (selectedIndex + 1) % characterTextures.size();
-            character.nextCostume(); // Chuyển trang phục tiếp theo
-            if (selectSound) Mix_PlayChannel(-1, selectSound, 0);
-        }
-    }
+    return !characterPaths.empty();
 }
 
-void CharacterSelector::render(SDL_Renderer* renderer, TTF_Font* font) {
-    // Thay thế render cũ bằng renderCharacterPreview
-    renderCharacterPreview(renderer, font);
-    
-    // Vẫn giữ phần vẽ mũi tên và text
-    // Draw arrows
-    SDL_SetRenderDrawColor(renderer, 100, 100, 100, 255);
-    SDL_RenderFillRect(renderer, &leftArrowRect);
-    SDL_RenderFillRect(renderer, &rightArrowRect);
-    
-    // Draw arrow shapes
-    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
-    // Left arrow
-    SDL_RenderDrawLine(renderer, leftArrowRect.x + 10, leftArrowRect.y + 15, 
-                     leftArrowRect.x + 20, leftArrowRect.y + 5);
-    SDL_RenderDrawLine(renderer, leftArrowRect.x + 10, leftArrowRect.y + 15, 
-                     leftArrowRect.x + 20, leftArrowRect.y + 25);
-    // Right arrow
-    SDL_RenderDrawLine(renderer, rightArrowRect.x + 10, rightArrowRect.y + 5, 
-                     rightArrowRect.x + 20, rightArrowRect.y + 15);
-    SDL_RenderDrawLine(renderer, rightArrowRect.x + 10, rightArrowRect.y + 25, 
-                     rightArrowRect.x + 20, rightArrowRect.y + 15);
-
-    // Draw "Select Character" text
-    if (font) {
-        SDL_Color textColor = {255, 255, 255, 255};
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, "Select Character", textColor);
-        if (textSurface) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            if (textTexture) {
-                int textX = (SCREEN_WIDTH - textSurface->w) / 2;
-                int textY = characterRect.y + characterRect.h + 20;
-                SDL_Rect textRect = {textX, textY, textSurface->w, textSurface->h};
-                SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-                SDL_DestroyTexture(textTexture);
-            }
-            SDL_FreeSurface(textSurface);
-        }
-    }
-}
 const std::string CHARACTER_NAMES[] = {
     "Elf",    // Tương ứng với selectedIndex = 0
     "Wizart", // Tương ứng với selectedIndex = 1
     "Knight"  // Tương ứng với selectedIndex = 2
 };
-void CharacterSelector::renderCharacterPreview(SDL_Renderer* renderer, TTF_Font* font) {
-    // Cập nhật animation
-    static Uint32 lastTime = 0;
-    Uint32 currentTime = SDL_GetTicks();
-    float deltaTime ;
-    if (lastTime == 0) {
-        deltaTime = 1.0f / 60.0f;
-    }
-    else {
-        deltaTime = (currentTime - lastTime) / 1000.0f;
-    }
-    const float MAX_ACCEPTABLE_DELTA_TIME = 0.25f;
-    if (deltaTime > MAX_ACCEPTABLE_DELTA_TIME) {
-        deltaTime = 1.0f / 60.0f;
-    }
-    if (deltaTime < 0.0f) {
-        deltaTime = 0.0f;
+
+void CharacterSelector::buildUi(Widget& menu, FontFace font) {
+    // Phần động (animation nhân vật) được vẽ riêng trong renderCharacterPreview
+    const int arrowSize = 30;
+    menu.add(std::make_unique<ArrowSelector>(
+        SDL_Rect{characterRect.x - 50, characterRect.y, characterRect.w + 100, characterRect.h},
+        arrowSize, UiAction::PREVIOUS_CHARACTER, UiAction::NEXT_CHARACTER));
+
+    Label* title = menu.add(std::make_unique<Label>(
+        SDL_Rect{0, characterRect.y + characterRect.h + 20, SCREEN_WIDTH, 0}, font, SDL_Color{255, 255, 255, 255}));
+    title->setTextId("select.character");
+
+    // Tên trang phục màu vàng, đặt dưới chữ "Select Character"
+    nameLabel = menu.add(std::make_unique<Label>(
+        SDL_Rect{characterRect.x, characterRect.y + characterRect.h + 40, characterRect.w, 0}, font, SDL_Color{255, 255, 0, 255}));
+    nameLabel->setText(CHARACTER_NAMES[character.getCurrentCostume()]);
+}
+
+bool CharacterSelector::step(int delta) {
+    if (characterPaths.empty()) return false;
+    int count = static_cast<int>(characterPaths.size());
+    selectedIndex = (selectedIndex + delta + count) % count;
+    if (delta < 0) {
+        character.prevCostume(); // Chuyển trang phục trước đó
+    } else {
+        character.nextCostume(); // Chuyển trang phục tiếp theo
     }
-    character.update(deltaTime);
-    lastTime = currentTime;
+    if (selectSound) Mix_PlayChannel(-1, selectSound.get(), 0);
+    if (nameLabel) nameLabel->setText(CHARACTER_NAMES[character.getCurrentCostume()]);
+    return true;
+}
+
+bool CharacterSelector::updatePreview(Uint32 now) {
+    const Uint32 interval = 1000 / CHARACTER_PREVIEW_FPS;
+    if (previewTick != 0 && now - previewTick < interval) return false;
+    // Lâu không cập nhật (đang ở màn hình khác) thì chỉ đi một nhịp, không chạy dồn
+    Uint32 elapsed = previewTick == 0 ? interval : now - previewTick;
+    if (elapsed > interval * 2) elapsed = interval;
+    character.update(elapsed / 1000.0f);
+    previewTick = now;
+    return true;
+}
+
+Uint32 CharacterSelector::previewDelay(Uint32 now) const {
+    const Uint32 interval = 1000 / CHARACTER_PREVIEW_FPS;
+    if (previewTick == 0 || now - previewTick >= interval) return 0;
+    return interval - (now - previewTick);
+}
 
+void CharacterSelector::renderCharacterPreview(SDL_Renderer* renderer) {
     // Vẽ nhân vật hiệp sĩ với animation
     character.render(renderer);
-    
-    // Vẽ tên trang phục
-    SDL_Color textColor = {255, 255, 0, 255}; // Màu vàng
-    std::string costumeName =CHARACTER_NAMES[character.getCurrentCostume()];
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, costumeName.c_str(), textColor);
-    
-    if (textSurface) {
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        if (textTexture) {
-            SDL_Rect textRect = {
-                characterRect.x + (characterRect.w - textSurface->w)/2,
-                characterRect.y + characterRect.h + 40, // Đặt dưới text "Select Character"
-                textSurface->w,
-                textSurface->h
-            };
-            SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-            SDL_DestroyTexture(textTexture);
-        }
-        SDL_FreeSurface(textSurface);
-    }
 }
 
 std::string CharacterSelector::getSelectedCharacterPath() const {
     return characterPaths.empty() ? "" : characterPaths[selectedIndex];
 }
 
-CharacterSelector::~CharacterSelector() {
-    for (auto texture : characterTextures) {
-        SDL_DestroyTexture(texture);
-    }
-    if (selectSound) Mix_FreeChunk(selectSound);
-}
\ No newline at end of file
+void CharacterSelector::release() {
+    character.setCostumes(std::vector<TextureHandle>());
+    selectSound.reset();
+}
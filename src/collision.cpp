@@ -0,0 +1,141 @@
+#include "collision.h"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define COLLISION_SSE2 1
+#endif
+
+namespace {
+// Thu hẹp khoảng [tEnter, tExit] theo một trục; trả về false nếu trục này không bao giờ chồng nhau
+bool clipAxis(float aMin, float aSize, float delta, float bMin, float bSize, float& tEnter, float& tExit) {
+    float aMax = aMin + aSize;
+    float bMax = bMin + bSize;
+    if (delta == 0.0f) {
+        return aMax > bMin && aMin < bMax;
+    }
+    float t0 = (bMin - aMax) / delta;
+    float t1 = (bMax - aMin) / delta;
+    if (t0 > t1) std::swap(t0, t1);
+    tEnter = std::max(tEnter, t0);
+    tExit = std::min(tExit, t1);
+    return tEnter < tExit;
+}
+
+const int MASK_BATCH = 32;
+
+// AND từng cặp word của hai dãy, true nếu có bit nào khác 0
+bool anyCommonBits(const Uint64* a, const Uint64* b, int count) {
+    int i = 0;
+#ifdef COLLISION_SSE2
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 2 <= count; i += 2) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        acc = _mm_or_si128(acc, _mm_and_si128(va, vb));
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xFFFF) return true;
+#endif
+    for (; i < count; ++i) {
+        if (a[i] & b[i]) return true;
+    }
+    return false;
+}
+}
+
+bool SweptAABB(const SDL_FRect& a, float dx, float dy, const SDL_FRect& b, float* toi, float* exitTime) {
+    float tEnter = 0.0f;
+    float tExit = 1.0f;
+    if (!clipAxis(a.x, a.w, dx, b.x, b.w, tEnter, tExit)) return false;
+    if (!clipAxis(a.y, a.h, dy, b.y, b.h, tEnter, tExit)) return false;
+    if (toi) *toi = tEnter;
+    if (exitTime) *exitTime = tExit;
+    return true;
+}
+
+CollisionMask::CollisionMask() : m_width(0), m_height(0), m_wordsPerRow(0) {}
+
+bool CollisionMask::build(SDL_Surface* surface, const SDL_Rect& src, int w, int h, Uint8 alphaThreshold) {
+    clear();
+    if (!surface || w <= 0 || h <= 0 || src.w <= 0 || src.h <= 0) return false;
+    if (src.x < 0 || src.y < 0 || src.x + src.w > surface->w || src.y + src.h > surface->h) {
+        std::cerr << "CollisionMask::build - Source rect is outside the surface" << std::endl;
+        return false;
+    }
+    SDL_Surface* argb = surface;
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        argb = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        if (!argb) {
+            std::cerr << "CollisionMask::build - Failed to convert surface: " << SDL_GetError() << std::endl;
+            return false;
+        }
+    }
+
+    m_width = w;
+    m_height = h;
+    m_wordsPerRow = (w + 63) / 64 + 1;
+    m_bits.assign(static_cast<size_t>(m_wordsPerRow) * h, 0);
+
+    if (SDL_MUSTLOCK(argb)) SDL_LockSurface(argb);
+    const Uint8* pixels = static_cast<const Uint8*>(argb->pixels);
+    for (int y = 0; y < h; ++y) {
+        int sy = src.y + y * src.h / h;
+        const Uint32* srcRow = reinterpret_cast<const Uint32*>(pixels + sy * argb->pitch);
+        Uint64* dstRow = &m_bits[static_cast<size_t>(y) * m_wordsPerRow];
+        for (int x = 0; x < w; ++x) {
+            int sx = src.x + x * src.w / w;
+            if ((srcRow[sx] >> 24) >= alphaThreshold) {
+                dstRow[x >> 6] |= Uint64(1) << (x & 63);
+            }
+        }
+    }
+    if (SDL_MUSTLOCK(argb)) SDL_UnlockSurface(argb);
+    if (argb != surface) SDL_FreeSurface(argb);
+    return true;
+}
+
+void CollisionMask::clear() {
+    m_width = m_height = m_wordsPerRow = 0;
+    m_bits.clear();
+}
+
+bool CollisionMask::empty() const { return m_bits.empty(); }
+int CollisionMask::width() const { return m_width; }
+int CollisionMask::height() const { return m_height; }
+
+Uint64 CollisionMask::bitsAt(int x, int y) const {
+    const Uint64* row = &m_bits[static_cast<size_t>(y) * m_wordsPerRow];
+    int word = x >> 6;
+    int shift = x & 63;
+    if (shift == 0) return row[word];
+    // Word đệm cuối hàng luôn bằng 0 nên có thể đọc word + 1
+    return (row[word] >> shift) | (row[word + 1] << (64 - shift));
+}
+
+bool MasksOverlap(const CollisionMask& a, int ax, int ay, const CollisionMask& b, int bx, int by) {
+    if (a.empty() || b.empty()) return false;
+    int x0 = std::max(ax, bx);
+    int y0 = std::max(ay, by);
+    int x1 = std::min(ax + a.width(), bx + b.width());
+    int y1 = std::min(ay + a.height(), by + b.height());
+    if (x0 >= x1 || y0 >= y1) return false;
+
+    // Gom các word đã căn theo cùng cột của vùng giao vào bộ đệm rồi AND theo lô
+    Uint64 bufA[MASK_BATCH];
+    Uint64 bufB[MASK_BATCH];
+    int count = 0;
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; x += 64) {
+            int remaining = x1 - x;
+            Uint64 keep = remaining >= 64 ? ~Uint64(0) : ((Uint64(1) << remaining) - 1);
+            bufA[count] = a.bitsAt(x - ax, y - ay) & keep;
+            bufB[count] = b.bitsAt(x - bx, y - by);
+            if (++count == MASK_BATCH) {
+                if (anyCommonBits(bufA, bufB, count)) return true;
+                count = 0;
+            }
+        }
+    }
+    return count > 0 && anyCommonBits(bufA, bufB, count);
+}
@@ -0,0 +1,186 @@
+#include "dialogue.h"
+#include "constants.h"
+#include "text_file.h"
+#include <algorithm>
+#include <iostream>
+
+DialogueScript::DialogueScript() : m_textArea({0, 0, 0, 0}), m_lineSkip(0) {}
+
+bool DialogueScript::load(const std::string& path, const AssetPack* pack) {
+    m_speakers.clear();
+    m_lines.clear();
+    m_pages.clear();
+    bool ok = ReadTextLines(path, pack, [&](const std::string& line, int lineNumber) {
+        if (line.compare(0, 9, "@portrait") == 0) {
+            size_t equals = line.find('=');
+            if (equals == std::string::npos) {
+                std::cerr << "DialogueScript::load - " << path << ":" << lineNumber << " has no '='" << std::endl;
+                return;
+            }
+            int speaker = findSpeaker(TrimText(line.substr(9, equals - 9)));
+            m_speakers[speaker].portraitPath = TrimText(line.substr(equals + 1));
+            return;
+        }
+
+        Line entry;
+        entry.speaker = -1;
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string name = TrimText(line.substr(0, colon));
+            if (!name.empty()) entry.speaker = findSpeaker(name);
+            entry.text = UnescapeText(TrimText(line.substr(colon + 1)));
+        } else {
+            entry.text = UnescapeText(line);
+        }
+        m_lines.push_back(entry);
+    });
+    if (!ok) {
+        std::cerr << "DialogueScript::load - Failed to read " << path << " - " << SDL_GetError() << std::endl;
+    }
+    return ok;
+}
+
+int DialogueScript::findSpeaker(const std::string& name) {
+    for (size_t i = 0; i < m_speakers.size(); ++i) {
+        if (m_speakers[i].name == name) return static_cast<int>(i);
+    }
+    DialogueSpeaker speaker;
+    speaker.name = name;
+    speaker.nameRun = {{}, 0, 0};
+    speaker.portrait = nullptr;
+    m_speakers.push_back(speaker);
+    return static_cast<int>(m_speakers.size()) - 1;
+}
+
+void DialogueScript::layout(TextRenderer& renderer, FontFace font, const SDL_Rect& textArea) {
+    m_textArea = textArea;
+    m_lineSkip = renderer.lineSkip(font);
+    m_pages.clear();
+    for (DialogueSpeaker& speaker : m_speakers) {
+        renderer.shape(font, speaker.name + ":", speaker.nameRun);
+    }
+
+    std::vector<std::string> wrapped;
+    for (const Line& line : m_lines) {
+        Uint32 missing = font ? renderer.findMissingGlyph(*font.sdf, line.text) : 0;
+        if (missing) {
+            char code[16];
+            SDL_snprintf(code, sizeof(code), "U+%04X", static_cast<unsigned>(missing));
+            std::cerr << "DialogueScript::layout - Font has no glyph " << code << " in: " << line.text << std::endl;
+        }
+        int nameHeight = line.speaker >= 0 ? m_speakers[line.speaker].nameRun.height + DIALOGUE_NAME_GAP : 0;
+        int linesPerPage = m_lineSkip > 0 ? std::max(1, (textArea.h - nameHeight) / m_lineSkip) : 1;
+
+        renderer.wrapLines(font, line.text, textArea.w, wrapped);
+        size_t next = 0;
+        do {
+            DialoguePage page;
+            page.speaker = line.speaker;
+            page.glyphCount = 0;
+            for (int i = 0; i < linesPerPage && next < wrapped.size(); ++i, ++next) {
+                page.lines.emplace_back();
+                renderer.shape(font, wrapped[next], page.lines.back());
+                page.glyphCount += page.lines.back().glyphs.size();
+            }
+            m_pages.push_back(std::move(page));
+        } while (next < wrapped.size());
+    }
+}
+
+std::vector<std::string> DialogueScript::portraitPaths() const {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < m_speakers.size(); ++i) {
+        const std::string& path = m_speakers[i].portraitPath;
+        if (path.empty() || std::find(paths.begin(), paths.end(), path) != paths.end()) continue;
+        bool speaks = std::any_of(m_lines.begin(), m_lines.end(),
+                                  [i](const Line& line) { return line.speaker == static_cast<int>(i); });
+        if (speaks) paths.push_back(path);
+    }
+    return paths;
+}
+
+void DialogueScript::bindPortraits(const StateAssets& assets) {
+    for (DialogueSpeaker& speaker : m_speakers) {
+        speaker.portrait = speaker.portraitPath.empty() ? nullptr : assets.texture(speaker.portraitPath);
+    }
+}
+
+size_t DialogueScript::pageCount() const {
+    return m_pages.size();
+}
+
+const DialoguePage& DialogueScript::page(size_t index) const {
+    return m_pages[index];
+}
+
+const DialogueSpeaker& DialogueScript::speaker(int index) const {
+    return m_speakers[static_cast<size_t>(index)];
+}
+
+const SDL_Rect& DialogueScript::textArea() const {
+    return m_textArea;
+}
+
+int DialogueScript::lineSkip() const {
+    return m_lineSkip;
+}
+
+DialoguePlayer::DialoguePlayer() : m_script(nullptr), m_page(0), m_revealed(0.0f) {}
+
+void DialoguePlayer::start(const DialogueScript* script) {
+    m_script = script;
+    m_page = 0;
+    m_revealed = 0.0f;
+}
+
+void DialoguePlayer::update(float dt) {
+    if (isFinished() || isPageComplete()) return;
+    m_revealed = std::min(m_revealed + dt * DIALOGUE_CHARS_PER_SECOND,
+                          static_cast<float>(m_script->page(m_page).glyphCount));
+}
+
+bool DialoguePlayer::advance() {
+    if (isFinished()) return false;
+    if (!isPageComplete()) {
+        m_revealed = static_cast<float>(m_script->page(m_page).glyphCount);
+        return true;
+    }
+    ++m_page;
+    m_revealed = 0.0f;
+    return !isFinished();
+}
+
+bool DialoguePlayer::isFinished() const {
+    return !m_script || m_page >= m_script->pageCount();
+}
+
+bool DialoguePlayer::isPageComplete() const {
+    return isFinished() || static_cast<size_t>(m_revealed) >= m_script->page(m_page).glyphCount;
+}
+
+void DialoguePlayer::render(SDL_Renderer* renderer, TextRenderer& textRenderer, FontFace font, const SDL_Rect& box) const {
+    if (isFinished()) return;
+    const DialoguePage& page = m_script->page(m_page);
+    const DialogueSpeaker* speaker = page.speaker >= 0 ? &m_script->speaker(page.speaker) : nullptr;
+
+    if (speaker && speaker->portrait) {
+        SDL_Rect portraitDestRect = {box.x + box.w - 150 - 10, box.y - 160, 150, 150};
+        SDL_RenderCopy(renderer, speaker->portrait, NULL, &portraitDestRect);
+    }
+
+    const SDL_Rect& area = m_script->textArea();
+    int y = area.y;
+    if (speaker) {
+        textRenderer.drawRun(font, speaker->nameRun, area.x, y, {255, 223, 0, 255});
+        y += speaker->nameRun.height + DIALOGUE_NAME_GAP;
+    }
+
+    // Chỉ vẽ phần đầu đã hiện, các dòng phía sau chưa tới lượt thì bỏ qua hẳn
+    size_t remaining = static_cast<size_t>(m_revealed);
+    for (const TextRun& line : page.lines) {
+        if (remaining == 0) break;
+        textRenderer.drawRun(font, line, area.x, y, {255, 255, 255, 255}, remaining);
+        remaining -= std::min(remaining, line.glyphs.size());
+        y += m_script->lineSkip();
+    }
+}
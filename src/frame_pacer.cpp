@@ -0,0 +1,110 @@
+#include "frame_pacer.h"
+#include <algorithm>
+
+namespace {
+const size_t STATS_WINDOW = 240;       // Số khung hình giữ lại để tính thống kê
+const double SPIN_MARGIN_MS = 2.0;     // SDL_Delay có thể trễ 1-2ms, đoạn cuối quay vòng cho chính xác
+}
+
+FramePacer::FramePacer()
+    : m_frequency(SDL_GetPerformanceFrequency()), m_period(0), m_frameStart(0), m_deadline(0),
+      m_spinTicks(0), m_targetFps(0), m_vsync(false), m_refreshRate(0),
+      m_frameMs(STATS_WINDOW, 0.0f), m_workMs(STATS_WINDOW, 0.0f), m_head(0), m_frameCount(0) {
+    m_spinTicks = static_cast<Uint64>(m_frequency * SPIN_MARGIN_MS / 1000.0);
+    m_frameStart = SDL_GetPerformanceCounter();
+    m_deadline = m_frameStart;
+}
+
+void FramePacer::setTargetFps(int fps) {
+    m_targetFps = std::max(0, fps);
+    m_period = m_targetFps > 0 ? m_frequency / m_targetFps : 0;
+    m_deadline = SDL_GetPerformanceCounter() + m_period;
+}
+
+int FramePacer::targetFps() const {
+    return m_targetFps;
+}
+
+void FramePacer::setVsync(bool enabled, int refreshRate) {
+    m_vsync = enabled;
+    m_refreshRate = std::max(0, refreshRate);
+}
+
+float FramePacer::beginFrame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    float elapsed = static_cast<float>(now - m_frameStart) / m_frequency;
+    m_frameStart = now;
+    return elapsed;
+}
+
+void FramePacer::endFrame() {
+    Uint64 workEnd = SDL_GetPerformanceCounter();
+
+    // Với vsync, SDL_RenderPresent đã chờ màn hình; chỉ tự chờ khi mục tiêu thấp hơn tần số quét
+    bool paced = m_period > 0 && !(m_vsync && (m_refreshRate == 0 || m_targetFps >= m_refreshRate));
+    if (paced) {
+        m_deadline += m_period;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now > m_deadline) {
+            // Trễ quá một khung hình: bắt đầu lại từ bây giờ thay vì chạy dồn để đuổi kịp
+            if (now - m_deadline > m_period) m_deadline = now;
+        } else {
+            while (m_deadline - now > m_spinTicks) {
+                Uint32 sleepMs = static_cast<Uint32>(toMs(m_deadline - now - m_spinTicks));
+                SDL_Delay(std::max<Uint32>(1, sleepMs));
+                now = SDL_GetPerformanceCounter();
+                if (now >= m_deadline) break;
+            }
+            while (SDL_GetPerformanceCounter() < m_deadline) {
+                // Quay vòng đoạn cuối để đúng mốc
+            }
+        }
+    }
+
+    Uint64 frameEnd = SDL_GetPerformanceCounter();
+    m_frameMs[m_head] = static_cast<float>(toMs(frameEnd - m_frameStart));
+    m_workMs[m_head] = static_cast<float>(toMs(workEnd - m_frameStart));
+    m_head = (m_head + 1) % STATS_WINDOW;
+    ++m_frameCount;
+}
+
+FrameStats FramePacer::stats() const {
+    FrameStats result = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, m_frameCount};
+    size_t count = static_cast<size_t>(std::min<Uint64>(m_frameCount, STATS_WINDOW));
+    if (count == 0) return result;
+
+    std::vector<float> samples;
+    samples.reserve(count);
+    double total = 0.0, work = 0.0;
+    for (size_t k = 0; k < count; ++k) {
+        size_t index = (m_head + STATS_WINDOW - 1 - k) % STATS_WINDOW;
+        samples.push_back(m_frameMs[index]);
+        total += m_frameMs[index];
+        work += m_workMs[index];
+    }
+    result.lastMs = samples.front();
+    result.averageMs = total / count;
+    result.workMs = work / count;
+    auto bounds = std::minmax_element(samples.begin(), samples.end());
+    result.minMs = *bounds.first;
+    result.maxMs = *bounds.second;
+    size_t p99 = std::min(count - 1, count * 99 / 100);
+    std::nth_element(samples.begin(), samples.begin() + p99, samples.end());
+    result.p99Ms = samples[p99];
+    return result;
+}
+
+Uint64 FramePacer::frameCount() const {
+    return m_frameCount;
+}
+
+void FramePacer::resetStats() {
+    std::fill(m_frameMs.begin(), m_frameMs.end(), 0.0f);
+    std::fill(m_workMs.begin(), m_workMs.end(), 0.0f);
+    m_head = 0;
+    m_frameCount = 0;
+}
+
+double FramePacer::toMs(Uint64 ticks) const {
+    return ticks * 1000.0 / m_frequency;
+}
@@ -0,0 +1,174 @@
+#include "image_cache.h"
+#include "mapped_file.h"
+#include <SDL_image.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+const Uint32 CACHE_MAGIC = 0x47494D43; // "CMIG"
+const Uint32 CACHE_VERSION = 1;
+
+struct CacheHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint64 sourceSize;
+    Sint64 sourceMtime;
+    Uint64 sourceHash;
+    Uint32 format;
+    Sint32 width;
+    Sint32 height;
+    Sint32 pitch;
+};
+
+Uint64 fnv1a(const Uint8* data, size_t size, Uint64 hash = 14695981039346656037ULL) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool statSource(const std::string& path, Uint64* size, Sint64* mtime) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return false;
+    *size = static_cast<Uint64>(st.st_size);
+    *mtime = static_cast<Sint64>(st.st_mtime);
+    return true;
+}
+
+bool hashFile(const std::string& path, Uint64* hash) {
+    MappedFile source;
+    if (!source.open(path)) return false;
+    *hash = fnv1a(source.data(), source.size());
+    return true;
+}
+}
+
+ImageCache::ImageCache() : m_hits(0), m_misses(0) {}
+
+void ImageCache::setDirectory(const std::string& directory) {
+    m_directory = directory;
+}
+
+bool ImageCache::isEnabled() const {
+    return !m_directory.empty();
+}
+
+std::string ImageCache::cachePath(const std::string& sourcePath) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "img_%016llx.bin",
+                  static_cast<unsigned long long>(fnv1a(reinterpret_cast<const Uint8*>(sourcePath.data()), sourcePath.size())));
+    return m_directory + name;
+}
+
+bool ImageCache::describe(const std::string& sourcePath, const AssetPack* pack, Source* out) const {
+    out->path = sourcePath;
+    PackedAsset asset;
+    if (pack && pack->find(sourcePath, &asset)) {
+        out->data = asset.data;
+        out->size = asset.size;
+        out->mtime = asset.mtime;
+        return true;
+    }
+    out->data = nullptr;
+    return statSource(sourcePath, &out->size, &out->mtime);
+}
+
+SDL_Surface* ImageCache::load(const Source& source) {
+    MappedFile cached;
+    if (!cached.open(cachePath(source.path)) || cached.size() < sizeof(CacheHeader)) return nullptr;
+    CacheHeader header;
+    std::memcpy(&header, cached.data(), sizeof(header));
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+        header.format != SDL_PIXELFORMAT_ARGB8888 || header.width <= 0 || header.height <= 0 ||
+        cached.size() < sizeof(CacheHeader) + static_cast<size_t>(header.pitch) * header.height) {
+        return nullptr;
+    }
+    // mtime đổi nhưng nội dung giống hệt (ví dụ file được chép lại) thì bản đệm vẫn dùng được
+    if (header.sourceSize != source.size || header.sourceMtime != source.mtime) {
+        if (header.sourceSize != source.size) return nullptr;
+        Uint64 hash = 0;
+        if (source.data) {
+            hash = fnv1a(source.data, source.size);
+        } else if (!hashFile(source.path, &hash)) {
+            return nullptr;
+        }
+        if (hash != header.sourceHash) return nullptr;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, header.width, header.height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return nullptr;
+    const Uint8* src = cached.data() + sizeof(CacheHeader);
+    Uint8* dst = static_cast<Uint8*>(surface->pixels);
+    size_t rowBytes = static_cast<size_t>(header.width) * 4;
+    for (int y = 0; y < header.height; ++y) {
+        std::memcpy(dst + static_cast<size_t>(y) * surface->pitch, src + static_cast<size_t>(y) * header.pitch, rowBytes);
+    }
+    return surface;
+}
+
+void ImageCache::store(const Source& source, SDL_Surface* surface) {
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) return;
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.sourceSize = source.size;
+    header.sourceMtime = source.mtime;
+    if (source.data) {
+        header.sourceHash = fnv1a(source.data, source.size);
+    } else if (!hashFile(source.path, &header.sourceHash)) {
+        return;
+    }
+    header.format = SDL_PIXELFORMAT_ARGB8888;
+    header.width = surface->w;
+    header.height = surface->h;
+    header.pitch = surface->w * 4;
+
+    // Ghi ra file tạm rồi đổi tên, để lần chạy khác không bao giờ đọc phải file ghi dở
+    std::string path = cachePath(source.path);
+    std::string temp = path + ".tmp";
+    SDL_RWops* out = SDL_RWFromFile(temp.c_str(), "wb");
+    if (!out) return;
+    bool ok = SDL_RWwrite(out, &header, sizeof(header), 1) == 1;
+    const Uint8* pixels = static_cast<const Uint8*>(surface->pixels);
+    for (int y = 0; ok && y < surface->h; ++y) {
+        ok = SDL_RWwrite(out, pixels + static_cast<size_t>(y) * surface->pitch, header.pitch, 1) == 1;
+    }
+    ok = SDL_RWclose(out) == 0 && ok;
+    std::remove(path.c_str());
+    if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+    }
+}
+
+SDL_Surface* ImageCache::loadImage(const std::string& sourcePath, const AssetPack* pack) {
+    Source source;
+    bool described = isEnabled() && describe(sourcePath, pack, &source);
+    if (described) {
+        SDL_Surface* surface = load(source);
+        if (surface) {
+            m_hits.fetch_add(1);
+            return surface;
+        }
+    }
+
+    SDL_Surface* decoded = IMG_Load_RW(pack ? pack->openRW(sourcePath) : SDL_RWFromFile(sourcePath.c_str(), "rb"), 1);
+    if (!decoded || !described) return decoded;
+    m_misses.fetch_add(1);
+
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(decoded, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!surface) return decoded; // Vẫn dùng được, chỉ là không ghi vào bộ đệm
+    SDL_FreeSurface(decoded);
+    store(source, surface);
+    return surface;
+}
+
+int ImageCache::hits() const {
+    return m_hits.load();
+}
+
+int ImageCache::misses() const {
+    return m_misses.load();
+}
@@ -0,0 +1,291 @@
+#include "job_system.h"
+#include "constants.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+// Chỉ số worker của luồng hiện tại, -1 nếu không phải worker (ví dụ luồng chính)
+thread_local int t_workerIndex = -1;
+
+struct StartInfo {
+    JobSystem* system;
+    int index;
+};
+}
+
+JobSystem::JobSystem()
+    : m_running(false), m_queued(0), m_nextWorker(0), m_sleepMutex(nullptr), m_sleepCond(nullptr),
+      m_doneMutex(nullptr), m_doneCond(nullptr), m_waiters(0) {}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+bool JobSystem::init(int workerCount) {
+    if (!m_workers.empty()) return true;
+    if (workerCount <= 0) workerCount = std::max(1, SDL_GetCPUCount() - 1);
+
+    m_sleepMutex = SDL_CreateMutex();
+    m_sleepCond = SDL_CreateCond();
+    m_doneMutex = SDL_CreateMutex();
+    m_doneCond = SDL_CreateCond();
+    if (!m_sleepMutex || !m_sleepCond || !m_doneMutex || !m_doneCond) {
+        std::cerr << "JobSystem::init - Failed to create sync objects: " << SDL_GetError() << std::endl;
+        shutdown();
+        return false;
+    }
+
+    m_running = true;
+    for (int i = 0; i < workerCount; ++i) {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->mutex = SDL_CreateMutex();
+        worker->thread = nullptr;
+        if (!worker->mutex) {
+            std::cerr << "JobSystem::init - Failed to create worker mutex: " << SDL_GetError() << std::endl;
+            break;
+        }
+        m_workers.push_back(std::move(worker));
+    }
+    // Tạo luồng sau khi đã có đủ deque để worker có thể trộm việc của nhau ngay
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        StartInfo* info = new StartInfo{this, static_cast<int>(i)};
+        m_workers[i]->thread = SDL_CreateThread(&JobSystem::threadMain, "job worker", info);
+        if (!m_workers[i]->thread) {
+            std::cerr << "JobSystem::init - Failed to create worker thread: " << SDL_GetError() << std::endl;
+            delete info;
+        }
+    }
+    return !m_workers.empty();
+}
+
+void JobSystem::shutdown() {
+    if (m_sleepMutex) SDL_LockMutex(m_sleepMutex);
+    m_running = false;
+    if (m_sleepCond) SDL_CondBroadcast(m_sleepCond);
+    if (m_sleepMutex) SDL_UnlockMutex(m_sleepMutex);
+
+    for (auto& worker : m_workers) {
+        if (worker->thread) SDL_WaitThread(worker->thread, nullptr);
+    }
+    for (auto& worker : m_workers) {
+        if (worker->mutex) SDL_DestroyMutex(worker->mutex);
+    }
+    m_workers.clear();
+    m_queued = 0;
+    if (m_sleepCond) SDL_DestroyCond(m_sleepCond);
+    if (m_sleepMutex) SDL_DestroyMutex(m_sleepMutex);
+    m_sleepCond = nullptr;
+    m_sleepMutex = nullptr;
+    if (m_doneCond) SDL_DestroyCond(m_doneCond);
+    if (m_doneMutex) SDL_DestroyMutex(m_doneMutex);
+    m_doneCond = nullptr;
+    m_doneMutex = nullptr;
+}
+
+int JobSystem::workerCount() const {
+    return static_cast<int>(m_workers.size());
+}
+
+JobHandle JobSystem::submit(std::function<void()> work, const std::vector<JobHandle>& deps) {
+    JobHandle job = std::make_shared<JobState>();
+    job->work = std::move(work);
+    job->pending = static_cast<int>(deps.size()) + 1;
+
+    for (const JobHandle& dep : deps) {
+        if (!dep) {
+            job->pending.fetch_sub(1);
+            continue;
+        }
+        while (dep->lock.test_and_set(std::memory_order_acquire)) {}
+        bool finished = dep->done.load();
+        if (!finished) dep->continuations.push_back(job);
+        dep->lock.clear(std::memory_order_release);
+        if (finished) job->pending.fetch_sub(1);
+    }
+
+    // Bỏ phần +1 giữ chỗ; nếu mọi phụ thuộc đã xong thì job sẵn sàng
+    if (job->pending.fetch_sub(1) == 1) {
+        enqueue(job);
+    }
+    return job;
+}
+
+void JobSystem::enqueue(const JobHandle& job) {
+    if (m_workers.empty()) {
+        // Chưa init: chạy ngay để job và các job phụ thuộc vẫn hoàn thành
+        execute(job);
+        return;
+    }
+    int index = t_workerIndex;
+    if (index < 0) index = static_cast<int>(m_nextWorker.fetch_add(1) % m_workers.size());
+
+    Worker& worker = *m_workers[index];
+    SDL_LockMutex(worker.mutex);
+    worker.jobs.push_back(job);
+    SDL_UnlockMutex(worker.mutex);
+    m_queued.fetch_add(1);
+
+    SDL_LockMutex(m_sleepMutex);
+    SDL_CondSignal(m_sleepCond);
+    SDL_UnlockMutex(m_sleepMutex);
+}
+
+JobHandle JobSystem::takeJob(int index) {
+    JobHandle job;
+    if (m_queued.load() == 0) return job;
+
+    // Deque của mình: lấy từ cuối (job mới nhất)
+    if (index >= 0) {
+        Worker& own = *m_workers[index];
+        SDL_LockMutex(own.mutex);
+        if (!own.jobs.empty()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+        }
+        SDL_UnlockMutex(own.mutex);
+        if (job) {
+            m_queued.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Trộm từ đầu deque của worker khác (job cũ nhất)
+    size_t count = m_workers.size();
+    size_t start = index >= 0 ? static_cast<size_t>(index) + 1 : 0;
+    for (size_t k = 0; k < count; ++k) {
+        Worker& victim = *m_workers[(start + k) % count];
+        SDL_LockMutex(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+        }
+        SDL_UnlockMutex(victim.mutex);
+        if (job) {
+            m_queued.fetch_sub(1);
+            return job;
+        }
+    }
+    return job;
+}
+
+JobHandle JobSystem::takeGroupJob(const void* group) {
+    JobHandle job;
+    if (m_queued.load() == 0) return job;
+    for (auto& worker : m_workers) {
+        SDL_LockMutex(worker->mutex);
+        auto it = std::find_if(worker->jobs.begin(), worker->jobs.end(),
+                               [group](const JobHandle& queued) { return queued->group == group; });
+        if (it != worker->jobs.end()) {
+            job = *it;
+            worker->jobs.erase(it);
+        }
+        SDL_UnlockMutex(worker->mutex);
+        if (job) {
+            m_queued.fetch_sub(1);
+            return job;
+        }
+    }
+    return job;
+}
+
+void JobSystem::execute(const JobHandle& job) {
+    if (job->work) job->work();
+    job->work = nullptr; // Giải phóng các biến đã capture
+
+    std::vector<JobHandle> ready;
+    while (job->lock.test_and_set(std::memory_order_acquire)) {}
+    job->done = true;
+    ready.swap(job->continuations);
+    job->lock.clear(std::memory_order_release);
+
+    for (const JobHandle& next : ready) {
+        if (next->pending.fetch_sub(1) == 1) enqueue(next);
+    }
+
+    if (m_waiters.load() > 0) {
+        SDL_LockMutex(m_doneMutex);
+        SDL_CondBroadcast(m_doneCond);
+        SDL_UnlockMutex(m_doneMutex);
+    }
+}
+
+void JobSystem::wait(const JobHandle& job) {
+    if (!job) return;
+    while (!job->done.load()) {
+        // Luồng ngoài (luồng chính, luồng mô phỏng) không được nhận job lạ, ví dụ giải mã ảnh dài,
+        // nếu không một bước mô phỏng có thể bị kẹt theo. Worker thì giúp mọi job để không tắc hàng đợi.
+        JobHandle other;
+        if (!m_workers.empty()) {
+            if (t_workerIndex >= 0) {
+                other = takeJob(t_workerIndex);
+            } else if (job->group) {
+                other = takeGroupJob(job->group);
+            }
+        }
+        if (other) {
+            execute(other);
+            continue;
+        }
+        SDL_LockMutex(m_doneMutex);
+        m_waiters.fetch_add(1);
+        if (!job->done.load()) {
+            // Có timeout để không kẹt nếu job cùng nhóm được gửi lại vào hàng đợi trong lúc ngủ
+            SDL_CondWaitTimeout(m_doneCond, m_doneMutex, JOB_IDLE_WAIT_MS);
+        }
+        m_waiters.fetch_sub(1);
+        SDL_UnlockMutex(m_doneMutex);
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    if (grain == 0) grain = 1;
+    if (m_workers.empty() || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    // Luồng gọi tự chạy đoạn đầu tiên thay vì ngồi chờ
+    // Các đoạn cùng nhóm nên luồng gọi có thể tự chạy những đoạn chưa worker nào nhận
+    std::vector<JobHandle> jobs;
+    jobs.reserve(count / grain + 1);
+    const void* group = &jobs;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        size_t end = std::min(count, begin + grain);
+        JobHandle job = std::make_shared<JobState>();
+        job->work = [&fn, begin, end]() { fn(begin, end); };
+        job->group = group;
+        enqueue(job);
+        jobs.push_back(job);
+    }
+    fn(0, grain);
+    for (const JobHandle& job : jobs) {
+        wait(job);
+    }
+}
+
+int JobSystem::threadMain(void* data) {
+    StartInfo* info = static_cast<StartInfo*>(data);
+    JobSystem* system = info->system;
+    int index = info->index;
+    delete info;
+    t_workerIndex = index;
+    system->workerLoop(index);
+    return 0;
+}
+
+void JobSystem::workerLoop(int index) {
+    while (m_running) {
+        JobHandle job = takeJob(index);
+        if (job) {
+            execute(job);
+            continue;
+        }
+        SDL_LockMutex(m_sleepMutex);
+        if (m_running && m_queued.load() == 0) {
+            // Có timeout để không kẹt nếu lỡ tín hiệu giữa lúc kiểm tra và lúc ngủ
+            SDL_CondWaitTimeout(m_sleepCond, m_sleepMutex, JOB_IDLE_WAIT_MS);
+        }
+        SDL_UnlockMutex(m_sleepMutex);
+    }
+}
@@ -1,48 +1,201 @@
 #include "obstacle.h"
 #include <SDL_image.h> 
 #include <iostream>   
-#include <algorithm>   // Cho std::remove_if
+#include <algorithm>
 #include <ctime>
-ObstacleManager::ObstacleManager() : m_renderer(nullptr), m_rng(std::time(nullptr)), m_baseSpeedFactor(2) {}
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OBSTACLE_USE_SSE2 1
+#endif
 
-ObstacleManager::~ObstacleManager() {
-    for (SDL_Texture* texture : m_obstacleTextures) {
-        if (texture) {
-            SDL_DestroyTexture(texture);
+namespace {
+// y += speed * dt cho toàn bộ kho
+void advanceKernel(float* y, const float* speed, size_t count, float deltaTime) {
+    size_t i = 0;
+#if OBSTACLE_USE_SSE2
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (; i + 4 <= count; i += 4) {
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 ps = _mm_loadu_ps(speed + i);
+        _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_mul_ps(ps, dt)));
+    }
+#endif
+    for (; i < count; ++i) {
+        y[i] += speed[i] * deltaTime;
+    }
+}
+
+// Đánh dấu các vật cản vừa vượt qua `limit`, trả về số vật cản mới được tính điểm
+int passKernel(const float* y, Uint8* flags, size_t count, float limit) {
+    int passedCount = 0;
+    size_t i = 0;
+#if OBSTACLE_USE_SSE2
+    const __m128 lim = _mm_set1_ps(limit);
+    for (; i + 4 <= count; i += 4) {
+        int mask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(y + i), lim));
+        if (!mask) continue;
+        for (int bit = 0; bit < 4; ++bit) {
+            Uint8& f = flags[i + bit];
+            if ((mask & (1 << bit)) && !(f & OBSTACLE_PASSED)) {
+                f |= OBSTACLE_PASSED;
+                ++passedCount;
+            }
         }
     }
-    m_obstacleTextures.clear();
+#endif
+    for (; i < count; ++i) {
+        if (y[i] > limit && !(flags[i] & OBSTACLE_PASSED)) {
+            flags[i] |= OBSTACLE_PASSED;
+            ++passedCount;
+        }
+    }
+    return passedCount;
+}
+
+// Xoá các vật cản có y > limit bằng cách dồn phần tử cuối vào chỗ trống, để lưới chỉ phải
+// cập nhật id của các phần tử bị di chuyển. Các khối 4 phần tử không có gì để xoá được bỏ qua.
+void compactKernel(ObstacleStore& store, SpatialGrid& grid, float limit) {
+    size_t count = store.size();
+    float* y = store.y.data();
+    size_t i = 0;
+#if OBSTACLE_USE_SSE2
+    const __m128 lim = _mm_set1_ps(limit);
+#endif
+    while (i < count) {
+#if OBSTACLE_USE_SSE2
+        if (i + 4 <= count && !_mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(y + i), lim))) {
+            i += 4;
+            continue;
+        }
+#endif
+        if (y[i] <= limit) {
+            ++i;
+            continue;
+        }
+        grid.remove(static_cast<int>(i));
+        size_t last = count - 1;
+        if (i != last) {
+            store.x[i] = store.x[last];
+            store.y[i] = store.y[last];
+            store.prevY[i] = store.prevY[last];
+            store.speed[i] = store.speed[last];
+            store.flags[i] = store.flags[last];
+            store.texture[i] = store.texture[last];
+            grid.relocate(static_cast<int>(last), static_cast<int>(i));
+        }
+        --count; // Không tăng i: phần tử vừa được dồn vào cần được kiểm tra lại
+    }
+    if (count != store.size()) {
+        store.x.resize(count);
+        store.y.resize(count);
+        store.prevY.resize(count);
+        store.speed.resize(count);
+        store.flags.resize(count);
+        store.texture.resize(count);
+    }
+}
+}
+
+void ObstacleStore::clear() {
+    x.clear();
+    y.clear();
+    prevY.clear();
+    speed.clear();
+    flags.clear();
+    texture.clear();
 }
 
-void ObstacleManager::loadTextures(SDL_Renderer* renderer) {
-    m_renderer = renderer;
+void ObstacleStore::reserve(size_t count) {
+    x.reserve(count);
+    y.reserve(count);
+    prevY.reserve(count);
+    speed.reserve(count);
+    flags.reserve(count);
+    texture.reserve(count);
+}
 
-    for (SDL_Texture* tex : m_obstacleTextures) { if (tex) SDL_DestroyTexture(tex); }
+void ObstacleStore::push(float px, float py, float pspeed, int ptexture) {
+    x.push_back(px);
+    y.push_back(py);
+    prevY.push_back(py);
+    speed.push_back(pspeed);
+    flags.push_back(0);
+    texture.push_back(ptexture);
+}
 
-    m_obstacleTextures.clear();
+SDL_Rect ObstacleStore::rect(size_t i) const {
+    return {static_cast<int>(x[i]), static_cast<int>(y[i]), OBSTACLE_SIZE, OBSTACLE_SIZE};
+}
+
+ObstacleManager::ObstacleManager()
+    : m_grid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_CELL_SIZE, OBSTACLE_SIZE), m_rng(static_cast<Uint32>(std::time(nullptr))),
+      m_seed(static_cast<Uint32>(std::time(nullptr))), m_seedPinned(false), m_baseSpeedFactor(INITIAL_SPEED_FACTOR),
+      m_maxObstacles(MAX_OBSTACLES), m_jobs(nullptr),
+      m_initialGrid(SCREEN_WIDTH, SCREEN_HEIGHT, COLLISION_CELL_SIZE, OBSTACLE_SIZE), m_initialReady(false) {
+    m_obstacles.reserve(MAX_OBSTACLES);
+}
+
+ObstacleManager::~ObstacleManager() {}
+
+std::vector<std::string> ObstacleManager::texturePaths() {
+    std::vector<std::string> paths;
     for (int i = 1; i <= 7; i++) {
-        std::string path = "assets/images/obstacles/" + std::to_string(i) + ".png";
-        SDL_Surface* surface = IMG_Load(path.c_str());
-        if (surface) {
-            SDL_Texture* texture = SDL_CreateTextureFromSurface(m_renderer, surface);
-            SDL_FreeSurface(surface);
-            if (texture) {
-                m_obstacleTextures.push_back(texture);
-            }
+        paths.push_back("assets/images/obstacles/" + std::to_string(i) + ".png");
+    }
+    return paths;
+}
+
+void ObstacleManager::loadTextures(TextureAtlas& atlas) {
+    m_regionIds.clear();
+    m_initialReady = false;
+    // Ảnh đã được đưa vào atlas từ trước (AssetLoader) sẽ không bị giải mã lại
+    for (const std::string& path : texturePaths()) {
+        int id = atlas.addImage(path);
+        if (id >= 0) {
+            m_regionIds.push_back(id);
         }
     }
 }
+void ObstacleManager::buildMasks(const TextureAtlas& atlas) {
+    m_masks.assign(m_regionIds.size(), CollisionMask());
+    if (!atlas.surface()) return;
+    for (size_t i = 0; i < m_regionIds.size(); ++i) {
+        m_masks[i].build(atlas.surface(), atlas.region(m_regionIds[i]).rect,
+                         OBSTACLE_SIZE, OBSTACLE_SIZE, COLLISION_ALPHA_THRESHOLD);
+    }
+}
+
+const CollisionMask* ObstacleManager::mask(int textureIndex) const {
+    if (textureIndex < 0 || static_cast<size_t>(textureIndex) >= m_masks.size()) return nullptr;
+    const CollisionMask& m = m_masks[textureIndex];
+    return m.empty() ? nullptr : &m;
+}
+
 void ObstacleManager::setBaseSpeedFactor(int factor) {
         m_baseSpeedFactor = std::max(1, factor); // Đảm bảo factor ít nhất là 1
     }
 
+void ObstacleManager::setJobSystem(JobSystem* jobs) {
+    m_jobs = jobs;
+}
+
+void ObstacleManager::setDensity(int maxObstacles) {
+    m_maxObstacles = std::max(1, maxObstacles);
+    m_obstacles.reserve(static_cast<size_t>(m_maxObstacles));
+    m_initialReady = false;
+}
+
+int ObstacleManager::getDensity() const {
+    return m_maxObstacles;
+}
+
 void ObstacleManager::spawnObstacles(int count) {
 
-    if (m_obstacleTextures.empty() || std::all_of(m_obstacleTextures.begin(), m_obstacleTextures.end(), [](SDL_Texture* t){ return t == nullptr; })) {
+    if (m_regionIds.empty()) {
         return;
     }
     int current_obstacle_count = m_obstacles.size();
-    int obstaclesToCreate = std::min(count, MAX_OBSTACLES - current_obstacle_count);
+    int obstaclesToCreate = std::min(count, m_maxObstacles - current_obstacle_count);
 
     if (obstaclesToCreate <= 0) {
         return;
@@ -50,67 +203,171 @@ void ObstacleManager::spawnObstacles(int count) {
 
     std::uniform_int_distribution<int> distX(0, SCREEN_WIDTH - OBSTACLE_SIZE);
     std::uniform_int_distribution<int> distSpeedBase(2, m_baseSpeedFactor);
-    std::uniform_int_distribution<int> distTexture(0, m_obstacleTextures.size() - 1);
+    std::uniform_int_distribution<int> distTexture(0, m_regionIds.size() - 1);
 
     for (int i = 0; i < obstaclesToCreate; ++i) {
         int speed_factor = distSpeedBase(m_rng);
         float speed_pps = static_cast<float>(speed_factor) * 60.0f;
 
         int spawn_y = -OBSTACLE_SIZE - (i * 150);
+        int spawn_x = distX(m_rng);
    
-        m_obstacles.push_back({
-            {distX(m_rng), spawn_y, OBSTACLE_SIZE, OBSTACLE_SIZE},
-            speed_pps,
-            false, // passed
-            distTexture(m_rng)
-        });
+        pushObstacle(static_cast<float>(spawn_x), static_cast<float>(spawn_y), speed_pps, distTexture(m_rng));
+    }
+}
+
+void ObstacleManager::pushObstacle(float x, float y, float speed, int texture) {
+    m_obstacles.push(x, y, speed, texture);
+    size_t id = m_obstacles.size() - 1;
+    m_grid.insert(static_cast<int>(id), m_obstacles.rect(id));
+}
+
+// Chế độ mật độ cao: rải vật cản ngẫu nhiên trong một dải cao bằng màn hình phía trên
+void ObstacleManager::spawnStress(int count) {
+    if (m_regionIds.empty() || count <= 0) {
+        return;
+    }
+    std::uniform_real_distribution<float> distX(0.0f, static_cast<float>(SCREEN_WIDTH - OBSTACLE_SIZE));
+    std::uniform_real_distribution<float> distY(static_cast<float>(-SCREEN_HEIGHT), static_cast<float>(-OBSTACLE_SIZE));
+    std::uniform_int_distribution<int> distSpeedBase(2, std::max(2, m_baseSpeedFactor));
+    std::uniform_int_distribution<int> distTexture(0, m_regionIds.size() - 1);
+
+    for (int i = 0; i < count; ++i) {
+        float speed_pps = static_cast<float>(distSpeedBase(m_rng)) * 60.0f;
+        pushObstacle(distX(m_rng), distY(m_rng), speed_pps, distTexture(m_rng));
     }
 }
 
 void ObstacleManager::update(float deltaTime, int& currentScore, Mix_Chunk* scoreSoundEffect) {
-    for (auto& obstacle : m_obstacles) {
-        obstacle.rect.y += static_cast<int>(obstacle.speed * deltaTime);
-
-        // Kiểm tra và tính điểm nếu vật cản đi qua màn hình
-        if (!obstacle.passed && obstacle.rect.y > SCREEN_HEIGHT) {
-            obstacle.passed = true;
-            currentScore++; // ObstacleManager cập nhật điểm trực tiếp
-            if (scoreSoundEffect) {
+    // Lưu vị trí đầu khung hình, di chuyển và kiểm tra vật cản đi qua màn hình.
+    // Mỗi vật cản độc lập nên có thể chia thành nhiều đoạn chạy song song (chế độ mật độ cao).
+    std::atomic<int> newlyPassed(0);
+    auto advanceRange = [&](size_t begin, size_t end) {
+        std::copy(m_obstacles.y.begin() + begin, m_obstacles.y.begin() + end, m_obstacles.prevY.begin() + begin);
+        advanceKernel(m_obstacles.y.data() + begin, m_obstacles.speed.data() + begin, end - begin, deltaTime);
+        int passed = passKernel(m_obstacles.y.data() + begin, m_obstacles.flags.data() + begin, end - begin,
+                                static_cast<float>(SCREEN_HEIGHT));
+        if (passed) newlyPassed.fetch_add(passed);
+    };
+    if (m_jobs) {
+        m_jobs->parallelFor(m_obstacles.size(), PARALLEL_OBSTACLE_GRAIN, advanceRange);
+    } else {
+        advanceRange(0, m_obstacles.size());
+    }
+
+    if (newlyPassed > 0) {
+        currentScore += newlyPassed; // ObstacleManager cập nhật điểm trực tiếp
+        if (scoreSoundEffect) {
+            // Chế độ thường: mỗi vật cản vượt qua một tiếng như trước.
+            // Chế độ mật độ cao có thể qua hàng nghìn vật cản một bước nên chỉ phát một tiếng.
+            int plays = m_maxObstacles > MAX_OBSTACLES ? 1 : newlyPassed.load();
+            for (int i = 0; i < plays; ++i) {
                 Mix_PlayChannel(-1, scoreSoundEffect, 0);
             }
         }
     }
 
-    // Xóa các vật cản đã đi qua và ra khỏi màn hình
-    m_obstacles.erase(
-        std::remove_if(m_obstacles.begin(), m_obstacles.end(),
-                       [](const Obstacle& o) {
-                           return o.passed && o.rect.y > SCREEN_HEIGHT + OBSTACLE_SIZE;
-                       }),
-        m_obstacles.end()
-    );
+    // Xóa các vật cản đã đi qua và ra khỏi màn hình (đã qua passKernel nên chắc chắn đã được tính điểm)
+    compactKernel(m_obstacles, m_grid, static_cast<float>(SCREEN_HEIGHT + OBSTACLE_SIZE));
+
+    // Lưới chỉ thay đổi ở những vật cản vừa sang ô khác
+    for (size_t i = 0; i < m_obstacles.size(); ++i) {
+        m_grid.update(static_cast<int>(i), m_obstacles.rect(i));
+    }
+
+    int current = static_cast<int>(m_obstacles.size());
+    if (m_maxObstacles > MAX_OBSTACLES) {
+        spawnStress(m_maxObstacles - current);
+        return;
+    }
     // Logic tạo vật cản mới (ví dụ: nếu số lượng ít hoặc vật cản cuối cùng đã di chuyển đủ xa)
     // Đây là một ví dụ đơn giản, bạn có thể cần tinh chỉnh điều kiện này
-    if (m_obstacles.size() < MAX_OBSTACLES / 2 ||
-        (!m_obstacles.empty() && m_obstacles.back().rect.y > -OBSTACLE_SIZE && m_obstacles.size() < MAX_OBSTACLES)) {
+    // Vật cản sinh sau luôn nằm cao nhất, nên "vật cản cuối cùng" là vật cản có y nhỏ nhất
+    if (current < m_maxObstacles / 2 ||
+        (!m_obstacles.empty() && *std::min_element(m_obstacles.y.begin(), m_obstacles.y.end()) > -OBSTACLE_SIZE &&
+         current < m_maxObstacles)) {
         spawnObstacles(1); // Tạo một vật cản mới. Khi count = 1, i = 0, nên spawn_y = -OBSTACLE_SIZE.
     }
 }
 
 
-void ObstacleManager::render(SDL_Renderer* renderer) {
-    for (const auto& obstacle : m_obstacles) {
-        if (static_cast<size_t>(obstacle.textureIndex) < m_obstacleTextures.size() && m_obstacleTextures[obstacle.textureIndex] != nullptr) {
-            SDL_RenderCopy(renderer, m_obstacleTextures[obstacle.textureIndex], NULL, &obstacle.rect);
+void ObstacleManager::render(SpriteBatch& batch, const TextureAtlas& atlas, const ObstacleStore& store, float alpha) const {
+    const float size = static_cast<float>(OBSTACLE_SIZE);
+    for (size_t i = 0; i < store.size(); ++i) {
+        float y = store.prevY[i] + (store.y[i] - store.prevY[i]) * alpha;
+        // Bỏ qua vật cản nằm ngoài màn hình (quan trọng ở chế độ mật độ cao)
+        if (y <= -size || y >= SCREEN_HEIGHT) continue;
+        int textureIndex = store.texture[i];
+        if (static_cast<size_t>(textureIndex) < m_regionIds.size()) {
+            SDL_FRect dst = {store.x[i], y, size, size};
+            batch.draw(atlas.region(m_regionIds[textureIndex]), NULL, dst);
         }
     }
 }
 
-void ObstacleManager::reset() {
+void ObstacleManager::copyState(ObstacleStore& out) const {
+    // Chỉ sao chép các mảng cần để vẽ; vector::operator= dùng lại bộ nhớ sẵn có khi đủ chỗ
+    out.x = m_obstacles.x;
+    out.y = m_obstacles.y;
+    out.prevY = m_obstacles.prevY;
+    out.texture = m_obstacles.texture;
+    out.speed.clear();
+    out.flags.clear();
+}
+
+void ObstacleManager::prepareInitialState() {
+    if (m_initialReady) return;
+    // Không có --seed: mỗi ván lấy seed mới từ chuỗi ngẫu nhiên đang chạy, như trước khi có seed
+    if (!m_seedPinned) m_seed = m_rng();
+    // Sinh thẳng vào bộ đệm đầu ván: đổi chỗ với trạng thái đang chơi rồi đổi lại,
+    // nên có thể gọi sẵn khi ván hiện tại đang dừng mà không làm thay đổi ván đó
+    std::swap(m_obstacles, m_initialObstacles);
+    std::swap(m_grid, m_initialGrid);
+    std::swap(m_rng, m_initialRng);
+    int liveSpeedFactor = m_baseSpeedFactor;
+    m_rng.seed(m_seed);
+    m_baseSpeedFactor = INITIAL_SPEED_FACTOR;
     m_obstacles.clear();
-   spawnObstacles(3);
+    m_grid.clear();
+    if (m_maxObstacles > MAX_OBSTACLES) {
+        spawnStress(m_maxObstacles);
+    } else {
+        spawnObstacles(3);
+    }
+    std::swap(m_obstacles, m_initialObstacles);
+    std::swap(m_grid, m_initialGrid);
+    std::swap(m_rng, m_initialRng);
+    m_baseSpeedFactor = liveSpeedFactor;
+    m_initialReady = true;
+}
+
+void ObstacleManager::reset() {
+    prepareInitialState();
+    // operator= của vector dùng lại bộ nhớ đã có khi đủ chỗ
+    m_obstacles = m_initialObstacles;
+    m_grid = m_initialGrid;
+    m_rng = m_initialRng;
+    m_baseSpeedFactor = INITIAL_SPEED_FACTOR;
+    // Chỉ giữ trạng thái đã sinh khi seed bị cố định, nếu không ván sau phải khác ván này
+    // (Game gọi lại prepareInitialState() khi ván dừng để lần reset sau vẫn chỉ là sao chép)
+    if (!m_seedPinned) m_initialReady = false;
+}
+
+void ObstacleManager::setSeed(Uint32 seed) {
+    m_seed = seed;
+    m_seedPinned = true;
+    m_rng.seed(seed);
+    m_initialReady = false;
 }
 
-const std::vector<Obstacle>& ObstacleManager::getObstacles() const {
+const ObstacleStore& ObstacleManager::getObstacles() const {
     return m_obstacles;
 }
+
+void ObstacleManager::queryCandidates(const SDL_Rect& rect, std::vector<int>& out) {
+    m_grid.query(rect, out);
+}
+
+float ObstacleManager::maxStep(float deltaTime) const {
+    return static_cast<float>(std::max(2, m_baseSpeedFactor)) * 60.0f * deltaTime;
+}
@@ -0,0 +1,317 @@
+#include "resource_manager.h"
+#include "pack_format.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+template <typename Map>
+void purgeMap(Map& map) {
+    for (auto it = map.begin(); it != map.end();) {
+        if (it->second.use_count() <= 1) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t estimateTextureBytes(SDL_Texture* texture, int* width, int* height) {
+    Uint32 format = 0;
+    int w = 0, h = 0;
+    SDL_QueryTexture(texture, &format, NULL, &w, &h);
+    int bpp = SDL_BYTESPERPIXEL(format);
+    if (bpp <= 0) bpp = 4; // Định dạng lạ (ví dụ YUV): coi như 32 bit
+    if (width) *width = w;
+    if (height) *height = h;
+    return static_cast<size_t>(w) * h * bpp;
+}
+}
+
+ResourceManager::ResourceManager()
+    : m_renderer(nullptr), m_imageCache(nullptr), m_pack(nullptr), m_textureBytes(0), m_engineTextureBytes(0),
+      m_textureBudget(0), m_useClock(0), m_evictions(0),
+      m_hits(0), m_misses(0) {}
+
+ResourceManager::~ResourceManager() {
+    release();
+}
+
+void ResourceManager::setRenderer(SDL_Renderer* renderer) {
+    m_renderer = renderer;
+}
+
+void ResourceManager::setImageCache(ImageCache* cache) {
+    m_imageCache = cache;
+}
+
+void ResourceManager::setAssetPack(const AssetPack* pack) {
+    m_pack = pack;
+}
+
+// Cùng cách chuẩn hoá với khoá trong pack
+std::string ResourceManager::normalize(const std::string& path) {
+    return NormalizeAssetPath(path);
+}
+
+SDL_RWops* ResourceManager::openRW(const std::string& path) const {
+    return m_pack ? m_pack->openRW(path) : SDL_RWFromFile(path.c_str(), "rb");
+}
+
+TextureHandle ResourceManager::texture(const std::string& path) {
+    std::string key = normalize(path);
+    auto it = m_textures.find(key);
+    if (it != m_textures.end()) {
+        ++m_hits;
+        it->second.lastUse = ++m_useClock;
+        return it->second.handle;
+    }
+    ++m_misses;
+    if (!m_renderer) return TextureHandle();
+    SDL_Texture* texture = nullptr;
+    if (m_imageCache) {
+        SDL_Surface* surface = m_imageCache->loadImage(path, m_pack);
+        if (surface) {
+            texture = SDL_CreateTextureFromSurface(m_renderer, surface);
+            SDL_FreeSurface(surface);
+        }
+    } else {
+        texture = IMG_LoadTexture_RW(m_renderer, openRW(path), 1);
+    }
+    if (!texture) {
+        std::cerr << "ResourceManager::texture - Failed to load image: " << path << " - " << IMG_GetError() << std::endl;
+        return TextureHandle();
+    }
+    return insertTexture(key, path, texture);
+}
+
+TextureHandle ResourceManager::insertTexture(const std::string& key, const std::string& path, SDL_Texture* texture) {
+    TextureEntry entry;
+    entry.path = path;
+    entry.handle = TextureHandle(texture, SDL_DestroyTexture);
+    entry.bytes = estimateTextureBytes(texture, nullptr, nullptr);
+    entry.lastUse = ++m_useClock;
+    entry.pinned = false;
+    TextureHandle handle = entry.handle;
+    m_textureBytes += entry.bytes;
+    m_textures[key] = entry;
+    // Texture vừa thêm đang được nơi gọi giữ handle nên không bị bỏ ở đây
+    enforceBudget();
+    return handle;
+}
+
+void ResourceManager::enforceBudget() {
+    if (m_textureBudget == 0) return;
+    // Texture của engine không bỏ được, chỉ thu hẹp phần ngân sách còn lại cho bảng
+    while (m_textureBytes + m_engineTextureBytes > m_textureBudget) {
+        auto victim = m_textures.end();
+        for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
+            const TextureEntry& entry = it->second;
+            if (entry.pinned || entry.handle.use_count() > 1) continue;
+            if (victim == m_textures.end() || entry.lastUse < victim->second.lastUse) victim = it;
+        }
+        if (victim == m_textures.end()) return; // Mọi texture còn lại đều đang được dùng
+        m_textureBytes -= victim->second.bytes;
+        m_textures.erase(victim);
+        ++m_evictions;
+    }
+}
+
+ChunkHandle ResourceManager::chunk(const std::string& path) {
+    std::string key = normalize(path);
+    auto it = m_chunks.find(key);
+    if (it != m_chunks.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_misses;
+    Mix_Chunk* chunk = Mix_LoadWAV_RW(openRW(path), 1);
+    if (!chunk) {
+        std::cerr << "ResourceManager::chunk - Failed to load sound: " << path << " - " << Mix_GetError() << std::endl;
+        return ChunkHandle();
+    }
+    ChunkHandle handle(chunk, Mix_FreeChunk);
+    m_chunks[key] = handle;
+    return handle;
+}
+
+MusicHandle ResourceManager::music(const std::string& path) {
+    std::string key = normalize(path);
+    auto it = m_music.find(key);
+    if (it != m_music.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_misses;
+    Mix_Music* music = Mix_LoadMUS_RW(openRW(path), 1);
+    if (!music) {
+        std::cerr << "ResourceManager::music - Failed to load music: " << path << " - " << Mix_GetError() << std::endl;
+        return MusicHandle();
+    }
+    MusicHandle handle(music, Mix_FreeMusic);
+    m_music[key] = handle;
+    return handle;
+}
+
+FontHandle ResourceManager::font(const std::string& path, int size) {
+    std::string key = normalize(path) + "#" + std::to_string(size);
+    auto it = m_fonts.find(key);
+    if (it != m_fonts.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_misses;
+    TTF_Font* font = TTF_OpenFontRW(openRW(path), 1, size);
+    if (!font) {
+        std::cerr << "ResourceManager::font - Failed to load font: " << path << " - " << TTF_GetError() << std::endl;
+        return FontHandle();
+    }
+    FontHandle handle(font, TTF_CloseFont);
+    m_fonts[key] = handle;
+    return handle;
+}
+
+TextureHandle ResourceManager::addTexture(const std::string& path, SDL_Texture* texture) {
+    if (!texture) return TextureHandle();
+    std::string key = normalize(path);
+    auto it = m_textures.find(key);
+    if (it != m_textures.end()) {
+        SDL_DestroyTexture(texture);
+        it->second.lastUse = ++m_useClock;
+        return it->second.handle;
+    }
+    return insertTexture(key, path, texture);
+}
+
+ChunkHandle ResourceManager::addChunk(const std::string& path, Mix_Chunk* chunk) {
+    if (!chunk) return ChunkHandle();
+    std::string key = normalize(path);
+    auto it = m_chunks.find(key);
+    if (it != m_chunks.end()) {
+        Mix_FreeChunk(chunk);
+        return it->second;
+    }
+    ChunkHandle handle(chunk, Mix_FreeChunk);
+    m_chunks[key] = handle;
+    return handle;
+}
+
+bool ResourceManager::contains(const std::string& path) const {
+    std::string key = normalize(path);
+    return m_textures.count(key) || m_chunks.count(key) || m_music.count(key);
+}
+
+void ResourceManager::pinTexture(const std::string& path, bool pinned) {
+    auto it = m_textures.find(normalize(path));
+    if (it != m_textures.end()) it->second.pinned = pinned;
+}
+
+void ResourceManager::setTextureBudget(size_t bytes) {
+    m_textureBudget = bytes;
+    enforceBudget();
+}
+
+void ResourceManager::trackTextures(const std::string& name, const std::vector<SDL_Texture*>& textures) {
+    EngineTextures usage = {0, 0, 0, 0};
+    for (SDL_Texture* texture : textures) {
+        if (!texture) continue;
+        int w = 0, h = 0;
+        usage.bytes += estimateTextureBytes(texture, &w, &h);
+        if (usage.count++ == 0) {
+            usage.width = w;
+            usage.height = h;
+        }
+    }
+    auto it = m_engineTextures.find(name);
+    size_t previous = it != m_engineTextures.end() ? it->second.bytes : 0;
+    if (it != m_engineTextures.end()) {
+        it->second = usage;
+    } else {
+        m_engineTextures.emplace(name, usage);
+    }
+    m_engineTextureBytes = m_engineTextureBytes - previous + usage.bytes;
+    if (usage.bytes > previous) enforceBudget();
+}
+
+void ResourceManager::unload(const std::string& path) {
+    std::string key = normalize(path);
+    auto it = m_textures.find(key);
+    if (it != m_textures.end()) {
+        m_textureBytes -= it->second.bytes;
+        m_textures.erase(it);
+    }
+    m_chunks.erase(key);
+    m_music.erase(key);
+}
+
+void ResourceManager::purgeUnused() {
+    for (auto it = m_textures.begin(); it != m_textures.end();) {
+        if (it->second.handle.use_count() <= 1) {
+            m_textureBytes -= it->second.bytes;
+            it = m_textures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    purgeMap(m_chunks);
+    purgeMap(m_music);
+    purgeMap(m_fonts);
+}
+
+void ResourceManager::release() {
+    m_textures.clear();
+    m_textureBytes = 0;
+    m_engineTextures.clear();
+    m_engineTextureBytes = 0;
+    m_chunks.clear();
+    m_music.clear();
+    m_fonts.clear();
+}
+
+ResourceStats ResourceManager::stats() const {
+    ResourceStats s;
+    s.hits = m_hits;
+    s.misses = m_misses;
+    s.textures = static_cast<int>(m_textures.size());
+    s.chunks = static_cast<int>(m_chunks.size());
+    s.music = static_cast<int>(m_music.size());
+    s.fonts = static_cast<int>(m_fonts.size());
+    s.textureBytes = m_textureBytes + m_engineTextureBytes;
+    s.engineTextureBytes = m_engineTextureBytes;
+    s.textureBudget = m_textureBudget;
+    s.evictions = m_evictions;
+    return s;
+}
+
+std::vector<TextureUsage> ResourceManager::textureUsage() const {
+    std::vector<TextureUsage> usage;
+    usage.reserve(m_textures.size() + m_engineTextures.size());
+    for (const auto& pair : m_textures) {
+        const TextureEntry& entry = pair.second;
+        TextureUsage row;
+        row.path = entry.path;
+        row.bytes = estimateTextureBytes(entry.handle.get(), &row.width, &row.height);
+        row.refs = entry.handle.use_count() - 1;
+        row.pinned = entry.pinned;
+        row.count = 1;
+        row.engine = false;
+        usage.push_back(row);
+    }
+    for (const auto& pair : m_engineTextures) {
+        if (pair.second.count == 0) continue;
+        TextureUsage row;
+        row.path = pair.first;
+        row.width = pair.second.width;
+        row.height = pair.second.height;
+        row.bytes = pair.second.bytes;
+        row.refs = 0;
+        row.pinned = true;
+        row.count = pair.second.count;
+        row.engine = true;
+        usage.push_back(row);
+    }
+    std::sort(usage.begin(), usage.end(), [](const TextureUsage& a, const TextureUsage& b) {
+        return a.bytes > b.bytes;
+    });
+    return usage;
+}
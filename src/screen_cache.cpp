@@ -0,0 +1,73 @@
+#include "screen_cache.h"
+#include <iostream>
+
+ScreenCache::ScreenCache() : m_renderer(nullptr), m_targetsSupported(false) {}
+
+ScreenCache::~ScreenCache() {
+    release();
+}
+
+bool ScreenCache::init(SDL_Renderer* renderer) {
+    m_renderer = renderer;
+    m_targetsSupported = SDL_RenderTargetSupported(renderer) == SDL_TRUE;
+    if (!m_targetsSupported) {
+        std::cerr << "ScreenCache::init - Render targets not supported, static screens will be redrawn every frame" << std::endl;
+    }
+    return m_targetsSupported;
+}
+
+void ScreenCache::release() {
+    for (auto& pair : m_entries) {
+        if (pair.second.texture) SDL_DestroyTexture(pair.second.texture);
+    }
+    m_entries.clear();
+}
+
+void ScreenCache::draw(GameState state, const std::function<void(SDL_Renderer*)>& compose) {
+    if (!m_targetsSupported) {
+        compose(m_renderer);
+        return;
+    }
+
+    Entry& entry = m_entries[static_cast<int>(state)];
+    if (!entry.texture) {
+        entry.texture = SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                          SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!entry.texture) {
+            std::cerr << "ScreenCache::draw - Failed to create target texture: " << SDL_GetError() << std::endl;
+            compose(m_renderer);
+            return;
+        }
+        SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_NONE);
+        entry.valid = false;
+    }
+
+    if (!entry.valid) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(m_renderer);
+        SDL_SetRenderTarget(m_renderer, entry.texture);
+        SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 255);
+        SDL_RenderClear(m_renderer);
+        compose(m_renderer);
+        SDL_SetRenderTarget(m_renderer, previousTarget);
+        entry.valid = true;
+    }
+
+    SDL_RenderCopy(m_renderer, entry.texture, NULL, NULL);
+}
+
+void ScreenCache::invalidate(GameState state) {
+    auto it = m_entries.find(static_cast<int>(state));
+    if (it != m_entries.end()) it->second.valid = false;
+}
+
+void ScreenCache::invalidateAll() {
+    for (auto& pair : m_entries) {
+        pair.second.valid = false;
+    }
+}
+
+void ScreenCache::collectTextures(std::vector<SDL_Texture*>& out) const {
+    for (const auto& pair : m_entries) {
+        if (pair.second.texture) out.push_back(pair.second.texture);
+    }
+}
@@ -0,0 +1,209 @@
+#include "sdf_font.h"
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+const int GLYPH_PADDING = 1;
+const int FAR_AWAY = 1 << 14;
+
+// Khoảng cách Euclid từ mỗi pixel tới pixel seed gần nhất (8SSEDT: hai lượt quét, lan truyền vector lệch)
+void distanceTransform(const std::vector<Uint8>& seed, int w, int h, std::vector<float>& out) {
+    std::vector<int> dx(w * h), dy(w * h);
+    for (int i = 0; i < w * h; ++i) {
+        dx[i] = dy[i] = seed[i] ? 0 : FAR_AWAY;
+    }
+    auto relax = [&](int x, int y, int ox, int oy) {
+        int nx = x + ox, ny = y + oy;
+        if (nx < 0 || ny < 0 || nx >= w || ny >= h) return;
+        int n = ny * w + nx, i = y * w + x;
+        int cx = dx[n] - ox, cy = dy[n] - oy;
+        if (cx * cx + cy * cy < dx[i] * dx[i] + dy[i] * dy[i]) {
+            dx[i] = cx;
+            dy[i] = cy;
+        }
+    };
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            relax(x, y, -1, 0);
+            relax(x, y, 0, -1);
+            relax(x, y, -1, -1);
+            relax(x, y, 1, -1);
+        }
+        for (int x = w - 1; x >= 0; --x) relax(x, y, 1, 0);
+    }
+    for (int y = h - 1; y >= 0; --y) {
+        for (int x = w - 1; x >= 0; --x) {
+            relax(x, y, 1, 0);
+            relax(x, y, 0, 1);
+            relax(x, y, 1, 1);
+            relax(x, y, -1, 1);
+        }
+        for (int x = 0; x < w; ++x) relax(x, y, -1, 0);
+    }
+    out.resize(w * h);
+    for (int i = 0; i < w * h; ++i) {
+        out[i] = std::sqrt(static_cast<float>(dx[i] * dx[i] + dy[i] * dy[i]));
+    }
+}
+}
+
+SdfFont::SdfFont()
+    : m_baseSize(0), m_height(0), m_lineSkip(0),
+      m_shelfX(0), m_shelfY(0), m_shelfHeight(0), m_atlasFullReported(false) {}
+
+bool SdfFont::load(const FontHandle& font, int baseSize) {
+    release();
+    if (!font) return false;
+    m_font = font;
+    m_baseSize = baseSize;
+    m_height = TTF_FontHeight(font.get());
+    m_lineSkip = TTF_FontLineSkip(font.get());
+    m_atlas.assign(static_cast<size_t>(SDF_ATLAS_SIZE) * SDF_ATLAS_SIZE, 0);
+    // Bake sẵn bảng ASCII in được để khung hình đầu tiên không phải rasterize
+    for (Uint32 ch = 32; ch < 127; ++ch) {
+        glyph(ch);
+    }
+    return true;
+}
+
+void SdfFont::release() {
+    m_font.reset();
+    m_glyphs.clear();
+    m_atlas.clear();
+    m_shelfX = m_shelfY = m_shelfHeight = 0;
+}
+
+bool SdfFont::isLoaded() const {
+    return m_font != nullptr;
+}
+
+const SdfFont::Glyph* SdfFont::glyph(Uint32 ch) {
+    auto it = m_glyphs.find(ch);
+    if (it != m_glyphs.end()) return &it->second;
+    Glyph& entry = m_glyphs[ch];
+    bake(ch, entry);
+    return &entry;
+}
+
+void SdfFont::bake(Uint32 ch, Glyph& glyph) {
+    glyph = {{0, 0, 0, 0}, 0, 0, 0};
+    int minx = 0, maxx = 0, miny = 0, maxy = 0, advance = 0;
+    // Font không có glyph này: ghi nhận glyph rỗng để không thử lại
+    if (!m_font || TTF_GlyphMetrics32(m_font.get(), ch, &minx, &maxx, &miny, &maxy, &advance) != 0) return;
+    glyph.advance = advance;
+    if (maxx <= minx) return;
+
+    SDL_Surface* rendered = TTF_RenderGlyph32_Blended(m_font.get(), ch, {255, 255, 255, 255});
+    if (!rendered) return;
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(rendered);
+    if (!surface) return;
+
+    // Chỉ giữ phần có nét cộng thêm SDF_SPREAD mỗi phía
+    auto alphaAt = [surface](int x, int y) {
+        const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(surface->pixels) + y * surface->pitch);
+        return static_cast<Uint8>(row[x] >> 24);
+    };
+    int left = surface->w, top = surface->h, right = -1, bottom = -1;
+    for (int y = 0; y < surface->h; ++y) {
+        for (int x = 0; x < surface->w; ++x) {
+            if (!alphaAt(x, y)) continue;
+            left = std::min(left, x);
+            right = std::max(right, x);
+            top = std::min(top, y);
+            bottom = std::max(bottom, y);
+        }
+    }
+    if (right < left) {
+        SDL_FreeSurface(surface);
+        return;
+    }
+
+    const int w = right - left + 1 + 2 * SDF_SPREAD;
+    const int h = bottom - top + 1 + 2 * SDF_SPREAD;
+    std::vector<Uint8> coverage(w * h, 0);
+    std::vector<Uint8> inside(w * h, 0);
+    std::vector<Uint8> outside(w * h, 1);
+    for (int y = 0; y <= bottom - top; ++y) {
+        for (int x = 0; x <= right - left; ++x) {
+            int i = (y + SDF_SPREAD) * w + x + SDF_SPREAD;
+            coverage[i] = alphaAt(left + x, top + y);
+            inside[i] = coverage[i] >= 128;
+            outside[i] = !inside[i];
+        }
+    }
+    SDL_FreeSurface(surface);
+
+    SDL_Rect rect;
+    if (!pack(w, h, rect)) return;
+
+    std::vector<float> distInside, distOutside;
+    distanceTransform(outside, w, h, distInside);
+    distanceTransform(inside, w, h, distOutside);
+    for (int y = 0; y < h; ++y) {
+        Uint8* row = &m_atlas[(rect.y + y) * SDF_ATLAS_SIZE + rect.x];
+        for (int x = 0; x < w; ++x) {
+            int i = y * w + x;
+            float d;
+            if (coverage[i] > 0 && coverage[i] < 255) {
+                // Pixel nằm trên biên: độ phủ cho vị trí biên chính xác hơn khoảng cách nguyên
+                d = coverage[i] / 255.0f - 0.5f;
+            } else if (inside[i]) {
+                d = distInside[i] - 0.5f;
+            } else {
+                d = 0.5f - distOutside[i];
+            }
+            float value = 128.0f + d * 127.0f / SDF_SPREAD;
+            row[x] = static_cast<Uint8>(std::max(0.0f, std::min(255.0f, value + 0.5f)));
+        }
+    }
+
+    glyph.src = rect;
+    glyph.offsetX = std::min(0, minx) + left - SDF_SPREAD;
+    glyph.offsetY = top - SDF_SPREAD;
+}
+
+bool SdfFont::pack(int w, int h, SDL_Rect& outRect) {
+    if (m_shelfX + w + GLYPH_PADDING > SDF_ATLAS_SIZE) {
+        m_shelfX = 0;
+        m_shelfY += m_shelfHeight + GLYPH_PADDING;
+        m_shelfHeight = 0;
+    }
+    if (w > SDF_ATLAS_SIZE || m_shelfY + h > SDF_ATLAS_SIZE) {
+        if (!m_atlasFullReported) {
+            std::cerr << "SdfFont - Distance field atlas is full, some glyphs will not be drawn" << std::endl;
+            m_atlasFullReported = true;
+        }
+        return false;
+    }
+    outRect = {m_shelfX, m_shelfY, w, h};
+    m_shelfX += w + GLYPH_PADDING;
+    m_shelfHeight = std::max(m_shelfHeight, h);
+    return true;
+}
+
+bool SdfFont::hasGlyph(Uint32 ch) const {
+    return m_font && TTF_GlyphIsProvided32(m_font.get(), ch);
+}
+
+int SdfFont::kerning(Uint32 prev, Uint32 ch) const {
+    return m_font ? TTF_GetFontKerningSizeGlyphs32(m_font.get(), prev, ch) : 0;
+}
+
+int SdfFont::baseSize() const {
+    return m_baseSize;
+}
+
+int SdfFont::height() const {
+    return m_height;
+}
+
+int SdfFont::lineSkip() const {
+    return m_lineSkip;
+}
+
+const Uint8* SdfFont::atlas() const {
+    return m_atlas.data();
+}
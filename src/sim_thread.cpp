@@ -0,0 +1,100 @@
+#include "sim_thread.h"
+#include "constants.h"
+#include <iostream>
+
+SimulationThread::SimulationThread()
+    : m_thread(nullptr), m_mutex(nullptr), m_running(false), m_active(false) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+bool SimulationThread::start(const std::function<void(float)>& step) {
+    if (m_thread) return true;
+    m_step = step;
+    m_mutex = SDL_CreateMutex();
+    if (!m_mutex) {
+        std::cerr << "SimulationThread::start - Failed to create mutex: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    m_running = true;
+    m_thread = SDL_CreateThread(&SimulationThread::threadMain, "simulation", this);
+    if (!m_thread) {
+        std::cerr << "SimulationThread::start - Failed to create thread: " << SDL_GetError() << std::endl;
+        m_running = false;
+        return false;
+    }
+    return true;
+}
+
+void SimulationThread::stop() {
+    m_running = false;
+    if (m_thread) {
+        SDL_WaitThread(m_thread, nullptr);
+        m_thread = nullptr;
+    }
+    if (m_mutex) {
+        SDL_DestroyMutex(m_mutex);
+        m_mutex = nullptr;
+    }
+}
+
+void SimulationThread::setActive(bool active) {
+    m_active = active;
+}
+
+void SimulationThread::lock() {
+    if (m_mutex) SDL_LockMutex(m_mutex);
+}
+
+void SimulationThread::unlock() {
+    if (m_mutex) SDL_UnlockMutex(m_mutex);
+}
+
+int SimulationThread::threadMain(void* data) {
+    static_cast<SimulationThread*>(data)->run();
+    return 0;
+}
+
+void SimulationThread::run() {
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 tickTicks = static_cast<Uint64>(frequency * SIM_DT);
+    Uint64 nextTick = SDL_GetPerformanceCounter();
+    bool wasActive = false;
+
+    while (m_running) {
+        if (!m_active) {
+            wasActive = false;
+            SDL_Delay(SIM_IDLE_SLEEP_MS);
+            continue;
+        }
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (!wasActive) {
+            // Vừa bắt đầu / tiếp tục chơi: không bù lại thời gian đã dừng
+            nextTick = now;
+            wasActive = true;
+        }
+
+        int steps = 0;
+        while (now >= nextTick && steps < MAX_SIM_STEPS_PER_FRAME) {
+            lock();
+            // setActive(false) rồi giữ khóa là đủ để chắc không còn bước nào chạy sau đó
+            if (!m_active) {
+                unlock();
+                break;
+            }
+            m_step(SIM_DT);
+            unlock();
+            nextTick += tickTicks;
+            ++steps;
+        }
+        // Máy quá chậm: bỏ phần tụt lại thay vì chạy dồn mãi
+        if (now >= nextTick) nextTick = now + tickTicks;
+
+        now = SDL_GetPerformanceCounter();
+        if (nextTick > now) {
+            Uint32 waitMs = static_cast<Uint32>((nextTick - now) * 1000 / frequency);
+            SDL_Delay(waitMs > 0 ? waitMs : 1);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "spatial_grid.h"
+#include <algorithm>
+
+namespace {
+const Sint16 NO_CELL = -1;
+}
+
+SpatialGrid::SpatialGrid(int width, int height, int cellSize, int maxItemSize)
+    : m_width(width), m_height(height), m_cellSize(cellSize),
+      m_cols((width + cellSize - 1) / cellSize), m_rows((height + cellSize - 1) / cellSize),
+      m_maxSpan((std::max(maxItemSize, 1) - 1) / cellSize + 2), m_slotsPerItem(m_maxSpan * m_maxSpan),
+      m_cells(static_cast<size_t>(m_cols * m_rows)), m_queryStamp(0) {}
+
+void SpatialGrid::clear() {
+    for (auto& cell : m_cells) cell.clear();
+    m_ranges.clear();
+    m_positions.clear();
+    m_stamps.clear();
+}
+
+SpatialGrid::CellRange SpatialGrid::rangeOf(const SDL_Rect& rect) const {
+    if (rect.w <= 0 || rect.h <= 0 ||
+        rect.x >= m_width || rect.y >= m_height || rect.x + rect.w <= 0 || rect.y + rect.h <= 0) {
+        return {0, 0, NO_CELL, NO_CELL};
+    }
+    int x0 = std::max(rect.x, 0) / m_cellSize;
+    int y0 = std::max(rect.y, 0) / m_cellSize;
+    int x1 = std::min(rect.x + rect.w - 1, m_width - 1) / m_cellSize;
+    int y1 = std::min(rect.y + rect.h - 1, m_height - 1) / m_cellSize;
+    return {static_cast<Sint16>(x0), static_cast<Sint16>(y0), static_cast<Sint16>(x1), static_cast<Sint16>(y1)};
+}
+
+SpatialGrid::CellRange SpatialGrid::itemRangeOf(const SDL_Rect& rect) const {
+    CellRange range = rangeOf(rect);
+    range.x1 = static_cast<Sint16>(std::min<int>(range.x1, range.x0 + m_maxSpan - 1));
+    range.y1 = static_cast<Sint16>(std::min<int>(range.y1, range.y0 + m_maxSpan - 1));
+    return range;
+}
+
+void SpatialGrid::addToCells(int id, const CellRange& range) {
+    int slot = 0;
+    for (int cy = range.y0; cy <= range.y1; ++cy) {
+        for (int cx = range.x0; cx <= range.x1; ++cx, ++slot) {
+            std::vector<CellEntry>& cell = m_cells[cy * m_cols + cx];
+            m_positions[id * m_slotsPerItem + slot] = static_cast<int>(cell.size());
+            cell.push_back({id, slot});
+        }
+    }
+}
+
+void SpatialGrid::removeFromCells(int id, const CellRange& range) {
+    int slot = 0;
+    for (int cy = range.y0; cy <= range.y1; ++cy) {
+        for (int cx = range.x0; cx <= range.x1; ++cx, ++slot) {
+            // Dồn phần tử cuối ô vào chỗ trống và sửa lại vị trí mà nó nhớ
+            std::vector<CellEntry>& cell = m_cells[cy * m_cols + cx];
+            int position = m_positions[id * m_slotsPerItem + slot];
+            const CellEntry& moved = cell.back();
+            m_positions[moved.id * m_slotsPerItem + moved.slot] = position;
+            cell[position] = moved;
+            cell.pop_back();
+        }
+    }
+}
+
+void SpatialGrid::insert(int id, const SDL_Rect& rect) {
+    if (static_cast<size_t>(id) >= m_ranges.size()) {
+        m_ranges.resize(id + 1, {0, 0, NO_CELL, NO_CELL});
+        m_positions.resize(static_cast<size_t>(id + 1) * m_slotsPerItem, 0);
+        m_stamps.resize(id + 1, 0);
+    }
+    CellRange range = itemRangeOf(rect);
+    m_ranges[id] = range;
+    addToCells(id, range);
+}
+
+void SpatialGrid::update(int id, const SDL_Rect& rect) {
+    CellRange range = itemRangeOf(rect);
+    CellRange& current = m_ranges[id];
+    if (range == current) return;
+    removeFromCells(id, current);
+    addToCells(id, range);
+    current = range;
+}
+
+void SpatialGrid::remove(int id) {
+    removeFromCells(id, m_ranges[id]);
+    m_ranges[id] = {0, 0, NO_CELL, NO_CELL};
+}
+
+void SpatialGrid::relocate(int fromId, int toId) {
+    const CellRange range = m_ranges[fromId];
+    int slot = 0;
+    for (int cy = range.y0; cy <= range.y1; ++cy) {
+        for (int cx = range.x0; cx <= range.x1; ++cx, ++slot) {
+            int position = m_positions[fromId * m_slotsPerItem + slot];
+            m_cells[cy * m_cols + cx][position].id = toId;
+            m_positions[toId * m_slotsPerItem + slot] = position;
+        }
+    }
+    m_ranges[toId] = range;
+    m_ranges[fromId] = {0, 0, NO_CELL, NO_CELL};
+}
+
+void SpatialGrid::query(const SDL_Rect& rect, std::vector<int>& out) {
+    CellRange range = rangeOf(rect);
+    if (range.x1 < range.x0) return;
+
+    if (++m_queryStamp == 0) {
+        std::fill(m_stamps.begin(), m_stamps.end(), 0);
+        m_queryStamp = 1;
+    }
+    for (int cy = range.y0; cy <= range.y1; ++cy) {
+        for (int cx = range.x0; cx <= range.x1; ++cx) {
+            for (const CellEntry& entry : m_cells[cy * m_cols + cx]) {
+                int id = entry.id;
+                if (m_stamps[id] == m_queryStamp) continue;
+                m_stamps[id] = m_queryStamp;
+                out.push_back(id);
+            }
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include "sprite_batch.h"
+
+SpriteBatch::SpriteBatch() : m_atlas(nullptr), m_invWidth(0.0f), m_invHeight(0.0f) {}
+
+void SpriteBatch::begin(const TextureAtlas& atlas) {
+    m_atlas = &atlas;
+    m_invWidth = atlas.width() > 0 ? 1.0f / atlas.width() : 0.0f;
+    m_invHeight = atlas.height() > 0 ? 1.0f / atlas.height() : 0.0f;
+    m_vertices.clear();
+    m_indices.clear();
+}
+
+void SpriteBatch::draw(const AtlasRegion& region, const SDL_Rect* src, const SDL_FRect& dst) {
+    float u0 = region.u0, v0 = region.v0, u1 = region.u1, v1 = region.v1;
+    if (src) {
+        u0 = (region.rect.x + src->x) * m_invWidth;
+        v0 = (region.rect.y + src->y) * m_invHeight;
+        u1 = (region.rect.x + src->x + src->w) * m_invWidth;
+        v1 = (region.rect.y + src->y + src->h) * m_invHeight;
+    }
+    const SDL_Color white = {255, 255, 255, 255};
+    float x1 = dst.x + dst.w;
+    float y1 = dst.y + dst.h;
+
+    int base = static_cast<int>(m_vertices.size());
+    m_vertices.push_back({{dst.x, dst.y}, white, {u0, v0}});
+    m_vertices.push_back({{x1, dst.y}, white, {u1, v0}});
+    m_vertices.push_back({{x1, y1}, white, {u1, v1}});
+    m_vertices.push_back({{dst.x, y1}, white, {u0, v1}});
+    m_indices.insert(m_indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void SpriteBatch::end(SDL_Renderer* renderer) {
+    if (m_atlas && m_atlas->texture() && !m_indices.empty()) {
+        SDL_RenderGeometry(renderer, m_atlas->texture(),
+                           m_vertices.data(), static_cast<int>(m_vertices.size()),
+                           m_indices.data(), static_cast<int>(m_indices.size()));
+    }
+    m_atlas = nullptr;
+}
+
+int SpriteBatch::spriteCount() const {
+    return static_cast<int>(m_vertices.size() / 4);
+}
@@ -0,0 +1,70 @@
+#include "state_assets.h"
+#include "constants.h"
+
+StateAssets::StateAssets(ResourceManager& resources, JobSystem* jobs, ImageCache* imageCache, const AssetPack* pack)
+    : m_resources(resources), m_state(IDLE) {
+    m_loader.setJobSystem(jobs);
+    m_loader.setImageCache(imageCache);
+    m_loader.setAssetPack(pack);
+}
+
+StateAssets::~StateAssets() {
+    evict();
+}
+
+void StateAssets::addTexture(const std::string& path) {
+    m_paths.push_back(path);
+}
+
+void StateAssets::prefetch() {
+    if (m_state != IDLE) return;
+    m_ids.clear();
+    for (const std::string& path : m_paths) {
+        m_ids.push_back(m_loader.queueImage(path, ASSET_TEXTURE));
+    }
+    m_loader.start();
+    m_state = LOADING;
+}
+
+void StateAssets::pump(SDL_Renderer* renderer) {
+    if (m_state != LOADING) return;
+    m_loader.pump(renderer, ASSET_UPLOADS_PER_FRAME);
+    if (m_loader.isDone()) commit();
+}
+
+void StateAssets::acquire(SDL_Renderer* renderer) {
+    prefetch();
+    if (m_state != LOADING) return;
+    m_loader.finish(renderer);
+    commit();
+}
+
+void StateAssets::commit() {
+    m_textures.clear();
+    for (int id : m_ids) {
+        m_textures.push_back(m_resources.addTexture(m_loader.path(id), m_loader.takeTexture(id)));
+    }
+    m_loader.release();
+    m_state = RESIDENT;
+}
+
+void StateAssets::evict() {
+    if (m_state == IDLE) return;
+    m_loader.release();
+    m_textures.clear();
+    for (const std::string& path : m_paths) {
+        m_resources.unload(path);
+    }
+    m_state = IDLE;
+}
+
+bool StateAssets::isResident() const {
+    return m_state == RESIDENT;
+}
+
+SDL_Texture* StateAssets::texture(const std::string& path) const {
+    for (size_t i = 0; i < m_paths.size() && i < m_textures.size(); ++i) {
+        if (m_paths[i] == path) return m_textures[i].get();
+    }
+    return nullptr;
+}
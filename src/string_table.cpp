@@ -0,0 +1,60 @@
+#include "string_table.h"
+#include "text_file.h"
+#include <iostream>
+
+bool StringTable::load(const std::string& path, const AssetPack* pack) {
+    std::unordered_map<std::string, std::string> strings;
+    bool ok = ReadTextLines(path, pack, [&](const std::string& line, int lineNumber) {
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cerr << "StringTable::load - " << path << ":" << lineNumber << " has no '='" << std::endl;
+            return;
+        }
+        std::string value = TrimText(line.substr(equals + 1));
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        strings[TrimText(line.substr(0, equals))] = UnescapeText(value);
+    });
+    if (!ok) {
+        std::cerr << "StringTable::load - Failed to read " << path << " - " << SDL_GetError() << std::endl;
+        return false;
+    }
+    m_strings.swap(strings);
+    m_runs.clear();
+    return true;
+}
+
+size_t StringTable::size() const {
+    return m_strings.size();
+}
+
+const std::string& StringTable::get(const std::string& id) {
+    auto it = m_strings.find(id);
+    if (it != m_strings.end()) return it->second;
+    std::cerr << "StringTable::get - Missing string: " << id << std::endl;
+    return m_strings[id] = id;
+}
+
+const TextRun& StringTable::run(TextRenderer& renderer, const std::string& id, FontFace font) {
+    FontRuns& runs = m_runs[id];
+    auto key = std::make_pair(static_cast<const SdfFont*>(font.sdf), font.size);
+    auto it = runs.find(key);
+    if (it != runs.end()) return it->second;
+    TextRun& run = runs[key];
+    renderer.shape(font, get(id), run);
+    return run;
+}
+
+size_t StringTable::checkCoverage(TextRenderer& renderer, const SdfFont& font) {
+    size_t missing = 0;
+    for (const auto& entry : m_strings) {
+        Uint32 ch = renderer.findMissingGlyph(font, entry.second);
+        if (!ch) continue;
+        char code[16];
+        SDL_snprintf(code, sizeof(code), "U+%04X", static_cast<unsigned>(ch));
+        std::cerr << "StringTable::checkCoverage - Font has no glyph " << code << " for: " << entry.first << std::endl;
+        ++missing;
+    }
+    return missing;
+}
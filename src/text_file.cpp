@@ -0,0 +1,46 @@
+#include "text_file.h"
+
+bool ReadTextLines(const std::string& path, const AssetPack* pack,
+                   const std::function<void(const std::string& line, int lineNumber)>& callback) {
+    SDL_RWops* rw = pack ? pack->openRW(path) : SDL_RWFromFile(path.c_str(), "rb");
+    size_t size = 0;
+    char* data = rw ? static_cast<char*>(SDL_LoadFile_RW(rw, &size, 1)) : nullptr;
+    if (!data) return false;
+    std::string text(data, size);
+    SDL_free(data);
+
+    // Bỏ BOM nếu file được lưu bằng trình soạn thảo thêm vào
+    size_t lineStart = text.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+    int lineNumber = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = text.size();
+        std::string line = TrimText(text.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') continue;
+        callback(line, lineNumber);
+    }
+    return true;
+}
+
+std::string TrimText(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return std::string();
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string UnescapeText(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size() && text[i + 1] == 'n') {
+            result += '\n';
+            ++i;
+        } else {
+            result += text[i];
+        }
+    }
+    return result;
+}
@@ -0,0 +1,412 @@
+#include "text_renderer.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const int ATLAS_SIZE = 1024;
+const int GLYPH_PADDING = 1;
+
+// Giải mã một ký tự UTF-8, trả về 0xFFFD nếu chuỗi không hợp lệ
+Uint32 decodeUtf8(const std::string& text, size_t& i) {
+    unsigned char c = static_cast<unsigned char>(text[i++]);
+    if (c < 0x80) return c;
+    int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : -1;
+    if (extra < 0) return 0xFFFD;
+    Uint32 cp = c & (0x3F >> extra);
+    for (int k = 0; k < extra; ++k) {
+        if (i >= text.size() || (static_cast<unsigned char>(text[i]) & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | (static_cast<unsigned char>(text[i++]) & 0x3F);
+    }
+    return cp;
+}
+
+bool isCombiningMark(Uint32 ch) {
+    return ch >= 0x0300 && ch <= 0x036F;
+}
+
+// Dạng dựng sẵn của nguyên âm tiếng Việt với dấu tổ hợp. Bảng chỉ ghi chữ hoa;
+// chữ thường là +0x20 với ký tự Latin-1 và +1 với phần còn lại.
+struct Composition {
+    Uint32 base;
+    Uint32 mark;
+    Uint32 composed;
+};
+const Uint32 MARK_GRAVE = 0x0300, MARK_ACUTE = 0x0301, MARK_CIRCUMFLEX = 0x0302, MARK_TILDE = 0x0303,
+             MARK_BREVE = 0x0306, MARK_HOOK = 0x0309, MARK_HORN = 0x031B, MARK_DOT_BELOW = 0x0323;
+const Uint32 TONE_MARKS[] = {MARK_GRAVE, MARK_ACUTE, MARK_TILDE, MARK_HOOK, MARK_DOT_BELOW};
+// Mỗi dòng: chữ gốc rồi dạng có dấu huyền, sắc, ngã, hỏi, nặng
+const Uint32 TONE_TABLE[][6] = {
+    {0x0041, 0x00C0, 0x00C1, 0x00C3, 0x1EA2, 0x1EA0},  // A
+    {0x0102, 0x1EB0, 0x1EAE, 0x1EB4, 0x1EB2, 0x1EB6},  // Ă
+    {0x00C2, 0x1EA6, 0x1EA4, 0x1EAA, 0x1EA8, 0x1EAC},  // Â
+    {0x0045, 0x00C8, 0x00C9, 0x1EBC, 0x1EBA, 0x1EB8},  // E
+    {0x00CA, 0x1EC0, 0x1EBE, 0x1EC4, 0x1EC2, 0x1EC6},  // Ê
+    {0x0049, 0x00CC, 0x00CD, 0x0128, 0x1EC8, 0x1ECA},  // I
+    {0x004F, 0x00D2, 0x00D3, 0x00D5, 0x1ECE, 0x1ECC},  // O
+    {0x00D4, 0x1ED2, 0x1ED0, 0x1ED6, 0x1ED4, 0x1ED8},  // Ô
+    {0x01A0, 0x1EDC, 0x1EDA, 0x1EE0, 0x1EDE, 0x1EE2},  // Ơ
+    {0x0055, 0x00D9, 0x00DA, 0x0168, 0x1EE6, 0x1EE4},  // U
+    {0x01AF, 0x1EEA, 0x1EE8, 0x1EEE, 0x1EEC, 0x1EF0},  // Ư
+    {0x0059, 0x1EF2, 0x00DD, 0x1EF8, 0x1EF6, 0x1EF4},  // Y
+};
+const Composition MODIFIER_TABLE[] = {
+    {0x0041, MARK_CIRCUMFLEX, 0x00C2}, {0x0041, MARK_BREVE, 0x0102}, {0x0045, MARK_CIRCUMFLEX, 0x00CA},
+    {0x004F, MARK_CIRCUMFLEX, 0x00D4}, {0x004F, MARK_HORN, 0x01A0}, {0x0055, MARK_HORN, 0x01AF},
+};
+
+Uint32 toLower(Uint32 upper) {
+    return upper < 0x100 ? upper + 0x20 : upper + 1;
+}
+
+// 0 nếu không có dạng dựng sẵn
+Uint32 composeVietnamese(Uint32 base, Uint32 mark) {
+    for (const Composition& entry : MODIFIER_TABLE) {
+        if (entry.mark != mark) continue;
+        if (entry.base == base) return entry.composed;
+        if (toLower(entry.base) == base) return toLower(entry.composed);
+    }
+    for (int tone = 0; tone < 5; ++tone) {
+        if (TONE_MARKS[tone] != mark) continue;
+        for (const auto& row : TONE_TABLE) {
+            if (row[0] == base) return row[tone + 1];
+            if (toLower(row[0]) == base) return toLower(row[tone + 1]);
+        }
+    }
+    return 0;
+}
+
+// Lấy mẫu song tuyến trong một vùng của atlas SDF, toạ độ tính theo pixel của vùng
+float sampleDistance(const Uint8* atlas, const SDL_Rect& rect, float x, float y) {
+    x = std::max(0.0f, std::min(x, static_cast<float>(rect.w - 1)));
+    y = std::max(0.0f, std::min(y, static_cast<float>(rect.h - 1)));
+    int x0 = static_cast<int>(x), y0 = static_cast<int>(y);
+    int x1 = std::min(x0 + 1, rect.w - 1), y1 = std::min(y0 + 1, rect.h - 1);
+    float fx = x - x0, fy = y - y0;
+    const Uint8* row0 = atlas + (rect.y + y0) * SDF_ATLAS_SIZE + rect.x;
+    const Uint8* row1 = atlas + (rect.y + y1) * SDF_ATLAS_SIZE + rect.x;
+    float top = row0[x0] + (row0[x1] - row0[x0]) * fx;
+    float bottom = row1[x0] + (row1[x1] - row1[x0]) * fx;
+    return top + (bottom - top) * fy;
+}
+}
+
+TextRenderer::TextRenderer()
+    : m_renderer(nullptr), m_atlasSurface(nullptr), m_atlasTexture(nullptr),
+      m_shelfX(0), m_shelfY(0), m_shelfHeight(0), m_dirtyRect({0, 0, 0, 0}),
+      m_hasDirty(false), m_atlasFullReported(false) {}
+
+TextRenderer::~TextRenderer() {
+    release();
+}
+
+void TextRenderer::release() {
+    if (m_atlasTexture) SDL_DestroyTexture(m_atlasTexture);
+    if (m_atlasSurface) SDL_FreeSurface(m_atlasSurface);
+    m_atlasTexture = nullptr;
+    m_atlasSurface = nullptr;
+    m_fonts.clear();
+    m_shelfX = m_shelfY = m_shelfHeight = 0;
+    m_hasDirty = false;
+}
+
+void TextRenderer::collectTextures(std::vector<SDL_Texture*>& out) const {
+    if (m_atlasTexture) out.push_back(m_atlasTexture);
+}
+
+bool TextRenderer::init(SDL_Renderer* renderer) {
+    m_renderer = renderer;
+    m_atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_SIZE, ATLAS_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!m_atlasSurface) {
+        std::cerr << "TextRenderer::init - Failed to create atlas surface: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_FillRect(m_atlasSurface, NULL, 0);
+
+    m_atlasTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, ATLAS_SIZE, ATLAS_SIZE);
+    if (!m_atlasTexture) {
+        std::cerr << "TextRenderer::init - Failed to create atlas texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(m_atlasTexture, SDL_BLENDMODE_BLEND);
+    SDL_UpdateTexture(m_atlasTexture, NULL, m_atlasSurface->pixels, m_atlasSurface->pitch);
+    return true;
+}
+
+TextRenderer::FontGlyphs* TextRenderer::getFont(FontFace font) {
+    auto key = std::make_pair(static_cast<const SdfFont*>(font.sdf), font.size);
+    auto it = m_fonts.find(key);
+    if (it != m_fonts.end()) return &it->second;
+
+    FontGlyphs& entry = m_fonts[key];
+    entry.scale = static_cast<float>(font.size) / font.sdf->baseSize();
+    entry.height = static_cast<int>(std::lround(font.sdf->height() * entry.scale));
+    entry.lineSkip = static_cast<int>(std::lround(font.sdf->lineSkip() * entry.scale));
+    // Dựng sẵn bảng ASCII in được để khung hình đầu tiên không phải dựng glyph
+    for (Uint32 ch = 32; ch < 127; ++ch) {
+        getGlyph(font, entry, ch);
+    }
+    return &entry;
+}
+
+const TextRenderer::Glyph* TextRenderer::getGlyph(FontFace font, FontGlyphs& entry, Uint32 ch) {
+    auto it = entry.glyphs.find(ch);
+    if (it != entry.glyphs.end()) return &it->second;
+
+    const SdfFont::Glyph* source = font.sdf->glyph(ch);
+    Glyph glyph = {{0, 0, 0, 0}, 0, 0, source->advance * entry.scale};
+    if (source->src.w > 0) {
+        resolveGlyph(*font.sdf, *source, entry.scale, glyph);
+    }
+    return &(entry.glyphs[ch] = glyph);
+}
+
+// Đổi khoảng cách thành độ phủ ở cỡ đích: biên nét được làm mượt trong đúng một pixel
+void TextRenderer::resolveGlyph(const SdfFont& sdf, const SdfFont::Glyph& source, float scale, Glyph& glyph) {
+    const int left = static_cast<int>(std::floor(source.offsetX * scale));
+    const int top = static_cast<int>(std::floor(source.offsetY * scale));
+    const int w = static_cast<int>(std::ceil((source.offsetX + source.src.w) * scale)) - left;
+    const int h = static_cast<int>(std::ceil((source.offsetY + source.src.h) * scale)) - top;
+    if (w <= 0 || h <= 0) return;
+
+    const float pixelsPerStep = scale * SDF_SPREAD / 127.0f;
+    m_glyphScratch.assign(static_cast<size_t>(w) * h, 0);
+    int minX = w, minY = h, maxX = -1, maxY = -1;
+    for (int y = 0; y < h; ++y) {
+        float sy = (top + y + 0.5f) / scale - source.offsetY - 0.5f;
+        for (int x = 0; x < w; ++x) {
+            float sx = (left + x + 0.5f) / scale - source.offsetX - 0.5f;
+            float coverage = (sampleDistance(sdf.atlas(), source.src, sx, sy) - 128.0f) * pixelsPerStep + 0.5f;
+            if (coverage <= 0.0f) continue;
+            Uint32 alpha = coverage >= 1.0f ? 255 : static_cast<Uint32>(coverage * 255.0f + 0.5f);
+            m_glyphScratch[y * w + x] = (alpha << 24) | 0x00FFFFFF;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+    }
+    if (maxX < minX) return;
+
+    // Chỉ đưa phần có nét vào atlas
+    SDL_Surface* glyphSurface = SDL_CreateRGBSurfaceWithFormatFrom(
+        &m_glyphScratch[minY * w + minX], maxX - minX + 1, maxY - minY + 1, 32, w * 4, SDL_PIXELFORMAT_ARGB8888);
+    if (!glyphSurface) return;
+    if (packGlyph(glyphSurface, glyph.src)) {
+        glyph.offsetX = left + minX;
+        glyph.offsetY = top + minY;
+    } else {
+        glyph.src = {0, 0, 0, 0};
+    }
+    SDL_FreeSurface(glyphSurface);
+}
+
+bool TextRenderer::packGlyph(SDL_Surface* glyphSurface, SDL_Rect& outRect) {
+    int w = glyphSurface->w;
+    int h = glyphSurface->h;
+    if (m_shelfX + w + GLYPH_PADDING > ATLAS_SIZE) {
+        m_shelfX = 0;
+        m_shelfY += m_shelfHeight + GLYPH_PADDING;
+        m_shelfHeight = 0;
+    }
+    if (w > ATLAS_SIZE || m_shelfY + h > ATLAS_SIZE) {
+        if (!m_atlasFullReported) {
+            std::cerr << "TextRenderer - Glyph atlas is full, some glyphs will not be drawn" << std::endl;
+            m_atlasFullReported = true;
+        }
+        return false;
+    }
+
+    outRect = {m_shelfX, m_shelfY, w, h};
+    SDL_SetSurfaceBlendMode(glyphSurface, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(glyphSurface, NULL, m_atlasSurface, &outRect);
+    outRect.w = w;
+    outRect.h = h;
+
+    m_shelfX += w + GLYPH_PADDING;
+    m_shelfHeight = std::max(m_shelfHeight, h);
+
+    if (m_hasDirty) {
+        SDL_UnionRect(&m_dirtyRect, &outRect, &m_dirtyRect);
+    } else {
+        m_dirtyRect = outRect;
+        m_hasDirty = true;
+    }
+    return true;
+}
+
+void TextRenderer::uploadDirty() {
+    if (!m_hasDirty) return;
+    const Uint8* pixels = static_cast<const Uint8*>(m_atlasSurface->pixels)
+                        + m_dirtyRect.y * m_atlasSurface->pitch + m_dirtyRect.x * 4;
+    SDL_UpdateTexture(m_atlasTexture, &m_dirtyRect, pixels, m_atlasSurface->pitch);
+    m_hasDirty = false;
+}
+
+void TextRenderer::shape(FontFace font, const std::string& text, TextRun& run) {
+    run.glyphs.clear();
+    run.width = 0;
+    run.height = 0;
+    if (!font) return;
+    FontGlyphs* entry = getFont(font);
+
+    float penX = 0.0f;
+    float baseAdvance = 0.0f;
+    size_t baseIndex = 0;
+    Uint32 prev = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        Uint32 ch = decodeUtf8(text, i);
+        if (isCombiningMark(ch) && !run.glyphs.empty()) {
+            ShapedGlyph& base = run.glyphs[baseIndex];
+            Uint32 composed = composeVietnamese(base.ch, ch);
+            if (composed && font.sdf->hasGlyph(composed)) {
+                // Thay chữ gốc bằng glyph dựng sẵn, bút tiến theo glyph mới
+                base.ch = composed;
+                baseAdvance = getGlyph(font, *entry, composed)->advance;
+                penX = base.x + baseAdvance;
+                prev = composed;
+                continue;
+            }
+            // Không có dạng dựng sẵn: đặt dấu lên giữa chữ gốc, không tiến bút
+            float markX = base.x + (baseAdvance - getGlyph(font, *entry, ch)->advance) / 2;
+            run.glyphs.push_back({ch, markX});
+            continue;
+        }
+
+        const Glyph* glyph = getGlyph(font, *entry, ch);
+        if (prev) penX += font.sdf->kerning(prev, ch) * entry->scale;
+        prev = ch;
+        baseIndex = run.glyphs.size();
+        baseAdvance = glyph->advance;
+        run.glyphs.push_back({ch, penX});
+        penX += glyph->advance;
+    }
+    run.width = static_cast<int>(std::lround(penX));
+    run.height = entry->height;
+}
+
+Uint32 TextRenderer::findMissingGlyph(const SdfFont& font, const std::string& text) {
+    Uint32 base = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        Uint32 ch = decodeUtf8(text, i);
+        if (ch < 0x20) continue;
+        if (isCombiningMark(ch) && base) {
+            Uint32 composed = composeVietnamese(base, ch);
+            if (composed && font.hasGlyph(composed)) {
+                base = composed;
+                continue;
+            }
+        } else {
+            base = ch;
+        }
+        if (!font.hasGlyph(ch)) return ch;
+    }
+    return 0;
+}
+
+void TextRenderer::drawRun(FontFace font, const TextRun& run, int x, int y, SDL_Color color, size_t maxGlyphs) {
+    if (!font || !m_atlasTexture || run.glyphs.empty()) return;
+    FontGlyphs* entry = getFont(font);
+
+    m_vertices.clear();
+    m_indices.clear();
+
+    const float invSize = 1.0f / ATLAS_SIZE;
+    const size_t count = std::min(maxGlyphs, run.glyphs.size());
+    for (size_t i = 0; i < count; ++i) {
+        const ShapedGlyph& shaped = run.glyphs[i];
+        const Glyph* glyph = getGlyph(font, *entry, shaped.ch);
+        if (glyph->src.w <= 0) continue;
+
+        // Bám theo pixel nguyên để glyph không bị nhoè khi vẽ
+        float x0 = std::round(x + shaped.x) + glyph->offsetX;
+        float y0 = static_cast<float>(y + glyph->offsetY);
+        float x1 = x0 + glyph->src.w;
+        float y1 = y0 + glyph->src.h;
+        float u0 = glyph->src.x * invSize;
+        float v0 = glyph->src.y * invSize;
+        float u1 = (glyph->src.x + glyph->src.w) * invSize;
+        float v1 = (glyph->src.y + glyph->src.h) * invSize;
+
+        int base = static_cast<int>(m_vertices.size());
+        m_vertices.push_back({{x0, y0}, color, {u0, v0}});
+        m_vertices.push_back({{x1, y0}, color, {u1, v0}});
+        m_vertices.push_back({{x1, y1}, color, {u1, v1}});
+        m_vertices.push_back({{x0, y1}, color, {u0, v1}});
+        m_indices.insert(m_indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+
+    uploadDirty();
+    if (!m_indices.empty()) {
+        SDL_RenderGeometry(m_renderer, m_atlasTexture,
+                           m_vertices.data(), static_cast<int>(m_vertices.size()),
+                           m_indices.data(), static_cast<int>(m_indices.size()));
+    }
+}
+
+void TextRenderer::drawText(FontFace font, const std::string& text, int x, int y, SDL_Color color) {
+    if (!font || !m_atlasTexture || text.empty()) return;
+    shape(font, text, m_runScratch);
+    drawRun(font, m_runScratch, x, y, color);
+}
+
+void TextRenderer::measureText(FontFace font, const std::string& text, int* w, int* h) {
+    shape(font, text, m_runScratch);
+    if (w) *w = m_runScratch.width;
+    if (h) *h = m_runScratch.height;
+}
+
+void TextRenderer::wrapLines(FontFace font, const std::string& text, int wrapWidth, std::vector<std::string>& lines) {
+    lines.clear();
+    std::string current;
+    std::string word;
+    int spaceWidth = 0;
+    measureText(font, " ", &spaceWidth, nullptr);
+
+    auto flushWord = [&]() {
+        if (word.empty()) return;
+        int wordWidth = 0, lineWidth = 0;
+        measureText(font, word, &wordWidth, nullptr);
+        measureText(font, current, &lineWidth, nullptr);
+        if (!current.empty() && lineWidth + spaceWidth + wordWidth > wrapWidth) {
+            lines.push_back(current);
+            current.clear();
+        }
+        if (!current.empty()) current += ' ';
+        current += word;
+        word.clear();
+    };
+
+    for (char c : text) {
+        if (c == ' ') {
+            flushWord();
+        } else if (c == '\n') {
+            flushWord();
+            lines.push_back(current);
+            current.clear();
+        } else {
+            word += c;
+        }
+    }
+    flushWord();
+    if (!current.empty()) lines.push_back(current);
+}
+
+int TextRenderer::lineSkip(FontFace font) {
+    return font ? getFont(font)->lineSkip : 0;
+}
+
+int TextRenderer::drawTextWrapped(FontFace font, const std::string& text, int x, int y, int wrapWidth, SDL_Color color) {
+    if (!font) return 0;
+    FontGlyphs* entry = getFont(font);
+
+    wrapLines(font, text, wrapWidth, m_lineScratch);
+    int lineY = y;
+    for (const auto& line : m_lineScratch) {
+        drawText(font, line, x, lineY, color);
+        lineY += entry->lineSkip;
+    }
+    return lineY - y;
+}
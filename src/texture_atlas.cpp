@@ -0,0 +1,140 @@
+#include "texture_atlas.h"
+#include <SDL_image.h>
+#include <iostream>
+#include <algorithm>
+
+namespace {
+const int ATLAS_WIDTH = 512;
+const int ATLAS_PADDING = 2;
+}
+
+TextureAtlas::TextureAtlas() : m_surface(nullptr), m_texture(nullptr) {}
+
+TextureAtlas::~TextureAtlas() {
+    release();
+    for (SDL_Surface* pending : m_pending) {
+        if (pending) SDL_FreeSurface(pending);
+    }
+    if (m_surface) SDL_FreeSurface(m_surface);
+}
+
+int TextureAtlas::addImage(const std::string& path) {
+    int existing = find(path);
+    if (existing >= 0) return existing;
+
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    if (!surface) {
+        std::cerr << "TextureAtlas::addImage - Failed to load image: " << path << " - " << IMG_GetError() << std::endl;
+        return -1;
+    }
+    return addSurface(path, surface);
+}
+
+int TextureAtlas::addSurface(const std::string& name, SDL_Surface* surface) {
+    if (!surface) return -1;
+    if (m_texture) {
+        std::cerr << "TextureAtlas::addSurface - Atlas already built, ignoring " << name << std::endl;
+        SDL_FreeSurface(surface);
+        return -1;
+    }
+    int id = static_cast<int>(m_regions.size());
+    m_regions.push_back({{0, 0, surface->w, surface->h}, 0.0f, 0.0f, 0.0f, 0.0f});
+    m_pending.push_back(surface);
+    m_names[name] = id;
+    return id;
+}
+
+bool TextureAtlas::build(SDL_Renderer* renderer) {
+    if (m_texture) return true;
+    if (m_regions.empty()) return false;
+
+    // Xếp theo chiều cao giảm dần rồi đóng gói theo từng kệ (shelf)
+    std::vector<int> order(m_regions.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_regions[a].rect.h > m_regions[b].rect.h;
+    });
+
+    int shelfX = ATLAS_PADDING, shelfY = ATLAS_PADDING, shelfHeight = 0;
+    for (int id : order) {
+        SDL_Rect& rect = m_regions[id].rect;
+        if (shelfX + rect.w + ATLAS_PADDING > ATLAS_WIDTH) {
+            shelfX = ATLAS_PADDING;
+            shelfY += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        rect.x = shelfX;
+        rect.y = shelfY;
+        shelfX += rect.w + ATLAS_PADDING;
+        shelfHeight = std::max(shelfHeight, rect.h);
+    }
+    int usedHeight = shelfY + shelfHeight + ATLAS_PADDING;
+    int atlasHeight = 1;
+    while (atlasHeight < usedHeight) atlasHeight <<= 1;
+
+    m_surface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, atlasHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!m_surface) {
+        std::cerr << "TextureAtlas::build - Failed to create atlas surface: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_FillRect(m_surface, NULL, 0);
+
+    for (size_t i = 0; i < m_regions.size(); ++i) {
+        AtlasRegion& region = m_regions[i];
+        SDL_Rect dst = region.rect;
+        SDL_SetSurfaceBlendMode(m_pending[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(m_pending[i], NULL, m_surface, &dst);
+        SDL_FreeSurface(m_pending[i]);
+        m_pending[i] = nullptr;
+
+        region.u0 = static_cast<float>(region.rect.x) / ATLAS_WIDTH;
+        region.v0 = static_cast<float>(region.rect.y) / atlasHeight;
+        region.u1 = static_cast<float>(region.rect.x + region.rect.w) / ATLAS_WIDTH;
+        region.v1 = static_cast<float>(region.rect.y + region.rect.h) / atlasHeight;
+    }
+    m_pending.clear();
+
+    m_texture = SDL_CreateTextureFromSurface(renderer, m_surface);
+    if (!m_texture) {
+        std::cerr << "TextureAtlas::build - Failed to create atlas texture: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    SDL_SetTextureBlendMode(m_texture, SDL_BLENDMODE_BLEND);
+    std::cout << "TextureAtlas::build - Packed " << m_regions.size() << " images into "
+              << ATLAS_WIDTH << "x" << atlasHeight << std::endl;
+    return true;
+}
+
+void TextureAtlas::release() {
+    if (m_texture) SDL_DestroyTexture(m_texture);
+    m_texture = nullptr;
+}
+
+bool TextureAtlas::isBuilt() const {
+    return m_texture != nullptr;
+}
+
+int TextureAtlas::find(const std::string& name) const {
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second : -1;
+}
+
+const AtlasRegion& TextureAtlas::region(int id) const {
+    return m_regions[static_cast<size_t>(id)];
+}
+
+SDL_Texture* TextureAtlas::texture() const {
+    return m_texture;
+}
+
+SDL_Surface* TextureAtlas::surface() const {
+    return m_surface;
+}
+
+int TextureAtlas::width() const {
+    return m_surface ? m_surface->w : 0;
+}
+
+int TextureAtlas::height() const {
+    return m_surface ? m_surface->h : 0;
+}
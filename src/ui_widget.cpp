@@ -0,0 +1,390 @@
+#include "ui_widget.h"
+#include <iostream>
+
+namespace {
+// Texture của widget chứa màu đã nhân alpha (vẽ chữ lên nền trong suốt), nên phải copy ra theo kiểu premultiplied
+SDL_BlendMode premultipliedBlendMode() {
+    return SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+}
+
+SDL_Rect shifted(const SDL_Rect& rect, SDL_Point offset) {
+    return {rect.x + offset.x, rect.y + offset.y, rect.w, rect.h};
+}
+}
+
+Widget::Widget(const SDL_Rect& frame)
+    : m_frame(frame), m_bounds(frame), m_parent(nullptr), m_action(UiAction::NONE), m_visible(true),
+      m_dirty(true), m_layoutDirty(true), m_descendantDirty(false), m_cache(nullptr), m_cacheRect({0, 0, 0, 0}) {}
+
+Widget::~Widget() {
+    if (m_cache) SDL_DestroyTexture(m_cache);
+}
+
+void Widget::adopt(std::unique_ptr<Widget> child) {
+    child->m_parent = this;
+    m_children.push_back(std::move(child));
+    invalidateLayout();
+}
+
+void Widget::setFrame(const SDL_Rect& frame) {
+    if (SDL_RectEquals(&frame, &m_frame)) return;
+    m_frame = frame;
+    invalidateLayout();
+}
+
+const SDL_Rect& Widget::frame() const {
+    return m_frame;
+}
+
+const SDL_Rect& Widget::bounds() const {
+    return m_bounds;
+}
+
+void Widget::setVisible(bool visible) {
+    if (visible == m_visible) return;
+    m_visible = visible;
+    // Cột của widget cha phải dàn lại, widget vừa hiện cần được vẽ
+    invalidateLayout();
+}
+
+bool Widget::isVisible() const {
+    return m_visible;
+}
+
+void Widget::setAction(UiAction action) {
+    m_action = action;
+}
+
+void Widget::markAncestors() {
+    for (Widget* parent = m_parent; parent && !parent->m_descendantDirty; parent = parent->m_parent) {
+        parent->m_descendantDirty = true;
+    }
+}
+
+void Widget::invalidate() {
+    m_dirty = true;
+    markAncestors();
+}
+
+void Widget::invalidateLayout() {
+    // Kích thước con đổi có thể làm đổi cách dàn của mọi widget phía trên
+    for (Widget* widget = this; widget; widget = widget->m_parent) {
+        widget->m_layoutDirty = true;
+    }
+    invalidate();
+}
+
+void Widget::invalidateAll() {
+    m_dirty = true;
+    m_descendantDirty = !m_children.empty();
+    for (auto& child : m_children) {
+        child->invalidateAll();
+    }
+}
+
+bool Widget::needsRedraw() const {
+    return m_dirty || m_layoutDirty || m_descendantDirty;
+}
+
+void Widget::layout(UiContext& ctx) {
+    if (!m_layoutDirty) return;
+    measureTree(ctx, false);
+    if (!m_parent) m_bounds = m_frame;
+    arrangeTree(false);
+}
+
+void Widget::measureTree(UiContext& ctx, bool force) {
+    if (!force && !m_layoutDirty) return;
+    measure(ctx);
+    for (auto& child : m_children) {
+        child->measureTree(ctx, true);
+    }
+}
+
+void Widget::arrangeTree(bool force) {
+    if (!force && !m_layoutDirty) return;
+    arrangeChildren();
+    m_layoutDirty = false;
+    for (auto& child : m_children) {
+        child->arrangeTree(true);
+    }
+}
+
+void Widget::place(const SDL_Rect& bounds) {
+    m_bounds = bounds;
+}
+
+void Widget::measure(UiContext&) {}
+
+void Widget::arrangeChildren() {
+    for (auto& child : m_children) {
+        const SDL_Rect& frame = child->frame();
+        child->place({m_bounds.x + frame.x, m_bounds.y + frame.y, frame.w, frame.h});
+    }
+}
+
+SDL_Rect Widget::paintRect() const {
+    return m_bounds;
+}
+
+void Widget::paint(UiContext&, SDL_Point) {}
+
+bool Widget::cachesContent() const {
+    return true;
+}
+
+void Widget::render(UiContext& ctx) {
+    layout(ctx);
+    renderTree(ctx);
+}
+
+void Widget::renderTree(UiContext& ctx) {
+    if (!m_visible) return;
+    renderContent(ctx);
+    for (auto& child : m_children) {
+        child->renderTree(ctx);
+    }
+    m_descendantDirty = false;
+}
+
+void Widget::renderContent(UiContext& ctx) {
+    if (!cachesContent() || !ctx.cacheTextures) {
+        paint(ctx, {0, 0});
+        m_dirty = false;
+        return;
+    }
+
+    SDL_Rect area = paintRect();
+    if (area.w <= 0 || area.h <= 0) {
+        m_dirty = false;
+        return;
+    }
+    if (m_cache && (m_cacheRect.w != area.w || m_cacheRect.h != area.h)) {
+        SDL_DestroyTexture(m_cache);
+        m_cache = nullptr;
+    }
+    if (!m_cache) {
+        m_cache = SDL_CreateTexture(ctx.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, area.w, area.h);
+        if (!m_cache) {
+            std::cerr << "Widget::renderContent - Failed to create cache texture: " << SDL_GetError() << std::endl;
+            paint(ctx, {0, 0});
+            m_dirty = false;
+            return;
+        }
+        if (SDL_SetTextureBlendMode(m_cache, premultipliedBlendMode()) != 0) {
+            SDL_SetTextureBlendMode(m_cache, SDL_BLENDMODE_BLEND);
+        }
+        m_dirty = true;
+    }
+    m_cacheRect = area;
+
+    if (m_dirty) {
+        SDL_Texture* previousTarget = SDL_GetRenderTarget(ctx.renderer);
+        SDL_SetRenderTarget(ctx.renderer, m_cache);
+        SDL_SetRenderDrawColor(ctx.renderer, 0, 0, 0, 0);
+        SDL_RenderClear(ctx.renderer);
+        paint(ctx, {-area.x, -area.y});
+        SDL_SetRenderTarget(ctx.renderer, previousTarget);
+        SDL_SetRenderDrawColor(ctx.renderer, 0, 0, 0, 255);
+        m_dirty = false;
+    }
+    SDL_RenderCopy(ctx.renderer, m_cache, NULL, &m_cacheRect);
+}
+
+Widget* Widget::hitTest(SDL_Point p) {
+    if (!m_visible) return nullptr;
+    // Con vẽ sau nằm trên nên được thử trước
+    for (auto it = m_children.rbegin(); it != m_children.rend(); ++it) {
+        if (Widget* hit = (*it)->hitTest(p)) return hit;
+    }
+    return hits(p) ? this : nullptr;
+}
+
+bool Widget::hits(SDL_Point p) const {
+    return m_action != UiAction::NONE && SDL_PointInRect(&p, &m_bounds);
+}
+
+UiAction Widget::click(SDL_Point) {
+    return m_action;
+}
+
+UiAction Widget::dispatch(const SDL_Event& event, UiContext& ctx) {
+    if (event.type != SDL_MOUSEBUTTONDOWN) return UiAction::NONE;
+    layout(ctx);
+    SDL_Point p = {event.button.x, event.button.y};
+    Widget* target = hitTest(p);
+    return target ? target->click(p) : UiAction::NONE;
+}
+
+void Widget::releaseCache() {
+    if (m_cache) {
+        SDL_DestroyTexture(m_cache);
+        m_cache = nullptr;
+    }
+    m_dirty = true;
+    for (auto& child : m_children) {
+        child->releaseCache();
+    }
+}
+
+void Widget::collectTextures(std::vector<SDL_Texture*>& out) const {
+    if (m_cache) out.push_back(m_cache);
+    for (const auto& child : m_children) {
+        child->collectTextures(out);
+    }
+}
+
+Panel::Panel(const SDL_Rect& frame)
+    : Widget(frame), m_background(nullptr), m_fill({0, 0, 0, 0}), m_column(false), m_columnTop(0), m_columnSpacing(0) {}
+
+void Panel::setBackground(SDL_Texture* texture) {
+    if (texture == m_background) return;
+    m_background = texture;
+    invalidate();
+}
+
+void Panel::setFill(SDL_Color color) {
+    m_fill = color;
+    invalidate();
+}
+
+void Panel::setColumn(int top, int spacing) {
+    m_column = true;
+    m_columnTop = top;
+    m_columnSpacing = spacing;
+    invalidateLayout();
+}
+
+void Panel::arrangeChildren() {
+    if (!m_column) {
+        Widget::arrangeChildren();
+        return;
+    }
+    int y = m_bounds.y + m_columnTop;
+    for (auto& child : m_children) {
+        if (!child->isVisible()) continue;
+        const SDL_Rect& frame = child->frame();
+        child->place({m_bounds.x + frame.x, y, frame.w, frame.h});
+        y += frame.h + m_columnSpacing;
+    }
+}
+
+void Panel::paint(UiContext& ctx, SDL_Point offset) {
+    SDL_Rect area = shifted(m_bounds, offset);
+    if (m_background) {
+        SDL_RenderCopy(ctx.renderer, m_background, NULL, &area);
+    }
+    if (m_fill.a > 0) {
+        SDL_SetRenderDrawBlendMode(ctx.renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(ctx.renderer, m_fill.r, m_fill.g, m_fill.b, m_fill.a);
+        SDL_RenderFillRect(ctx.renderer, &area);
+        SDL_SetRenderDrawBlendMode(ctx.renderer, SDL_BLENDMODE_NONE);
+    }
+}
+
+bool Panel::cachesContent() const {
+    // Nền đã là một texture, lưu thêm một bản chỉ tốn bộ nhớ
+    return false;
+}
+
+Label::Label(const SDL_Rect& frame, FontFace font, SDL_Color color)
+    : Widget(frame), m_font(font), m_color(color), m_isId(false), m_textChanged(false), m_autoHeight(frame.h == 0),
+      m_run({{}, 0, 0}) {}
+
+void Label::setTextId(const std::string& id) {
+    if (m_isId && id == m_text) return;
+    m_text = id;
+    m_isId = true;
+    m_textChanged = true;
+    invalidateLayout();
+}
+
+void Label::setText(const std::string& text) {
+    if (!m_isId && text == m_text) return;
+    m_text = text;
+    m_isId = false;
+    m_textChanged = true;
+    invalidateLayout();
+}
+
+void Label::setColor(SDL_Color color) {
+    m_color = color;
+    invalidate();
+}
+
+void Label::measure(UiContext& ctx) {
+    if (m_textChanged) {
+        m_textChanged = false;
+        if (!m_font || m_text.empty()) {
+            m_run = {{}, 0, 0};
+        } else if (m_isId) {
+            m_run = ctx.strings->run(*ctx.text, m_text, m_font);
+        } else {
+            ctx.text->shape(m_font, m_text, m_run);
+        }
+    }
+    if (m_autoHeight) m_frame.h = m_run.height;
+}
+
+SDL_Rect Label::textRect() const {
+    return {m_bounds.x + (m_bounds.w - m_run.width) / 2, m_bounds.y + (m_bounds.h - m_run.height) / 2,
+            m_run.width, m_run.height};
+}
+
+SDL_Rect Label::paintRect() const {
+    return textRect();
+}
+
+void Label::paint(UiContext& ctx, SDL_Point offset) {
+    if (m_run.glyphs.empty()) return;
+    SDL_Rect area = shifted(textRect(), offset);
+    ctx.text->drawRun(m_font, m_run, area.x, area.y, m_color);
+}
+
+Button::Button(const SDL_Rect& frame, FontFace font, const std::string& textId, UiAction action)
+    : Label(frame, font, {255, 255, 255, 255}) {
+    setTextId(textId);
+    setAction(action);
+}
+
+SDL_Rect Button::textRect() const {
+    SDL_Rect rect = Label::textRect();
+    rect.x += UI_BUTTON_TEXT_OFFSET_X;
+    return rect;
+}
+
+ArrowSelector::ArrowSelector(const SDL_Rect& frame, int arrowSize, UiAction previous, UiAction next)
+    : Widget(frame), m_arrowSize(arrowSize), m_previous(previous), m_next(next) {}
+
+SDL_Rect ArrowSelector::arrowRect(bool right) const {
+    int x = right ? m_bounds.x + m_bounds.w - m_arrowSize : m_bounds.x;
+    return {x, m_bounds.y + (m_bounds.h - m_arrowSize) / 2, m_arrowSize, m_arrowSize};
+}
+
+void ArrowSelector::paint(UiContext& ctx, SDL_Point offset) {
+    SDL_Rect left = shifted(arrowRect(false), offset);
+    SDL_Rect right = shifted(arrowRect(true), offset);
+    SDL_SetRenderDrawColor(ctx.renderer, 100, 100, 100, 255);
+    SDL_RenderFillRect(ctx.renderer, &left);
+    SDL_RenderFillRect(ctx.renderer, &right);
+
+    // Mũi tên là hai nét chéo trong ô vuông
+    const int s = m_arrowSize;
+    SDL_SetRenderDrawColor(ctx.renderer, 255, 255, 255, 255);
+    SDL_RenderDrawLine(ctx.renderer, left.x + s / 3, left.y + s / 2, left.x + s * 2 / 3, left.y + s / 6);
+    SDL_RenderDrawLine(ctx.renderer, left.x + s / 3, left.y + s / 2, left.x + s * 2 / 3, left.y + s * 5 / 6);
+    SDL_RenderDrawLine(ctx.renderer, right.x + s / 3, right.y + s / 6, right.x + s * 2 / 3, right.y + s / 2);
+    SDL_RenderDrawLine(ctx.renderer, right.x + s / 3, right.y + s * 5 / 6, right.x + s * 2 / 3, right.y + s / 2);
+}
+
+bool ArrowSelector::hits(SDL_Point p) const {
+    SDL_Rect left = arrowRect(false);
+    SDL_Rect right = arrowRect(true);
+    return SDL_PointInRect(&p, &left) || SDL_PointInRect(&p, &right);
+}
+
+UiAction ArrowSelector::click(SDL_Point p) {
+    SDL_Rect left = arrowRect(false);
+    return SDL_PointInRect(&p, &left) ? m_previous : m_next;
+}
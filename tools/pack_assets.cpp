@@ -0,0 +1,114 @@
+// Đóng gói mọi file trong thư mục asset vào một file pack có chỉ mục (xem pack_format.h).
+// Cách dùng: pack_assets <thư mục asset> <file pack>
+#include "pack_format.h"
+#include <sys/stat.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+struct SourceFile {
+    fs::path path;
+    std::string key;    // Đường dẫn tương đối kể cả tên thư mục asset, ví dụ "assets/images/hdieu.png"
+    uint64_t size;
+    int64_t mtime;
+};
+
+void writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+    static const char zeros[PACK_ALIGNMENT] = {};
+    out.write(zeros, static_cast<std::streamsize>(to - from));
+}
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: pack_assets <asset dir> <output pack>" << std::endl;
+        return 1;
+    }
+    // "assets/" và "assets" phải cho cùng tiền tố khóa: bỏ dấu phân cách ở cuối để filename() không rỗng
+    fs::path root = fs::path(argv[1]).lexically_normal();
+    if (root.filename().empty()) root = root.parent_path();
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        std::cerr << "pack_assets - Not a directory: " << root.string() << std::endl;
+        return 1;
+    }
+
+    std::vector<SourceFile> files;
+    for (const auto& item : fs::recursive_directory_iterator(root)) {
+        if (!item.is_regular_file()) continue;
+        SourceFile file;
+        file.path = item.path();
+        file.key = NormalizeAssetPath((root.filename() / fs::relative(item.path(), root)).generic_string());
+        struct stat st;
+        if (stat(file.path.string().c_str(), &st) != 0) {
+            std::cerr << "pack_assets - Cannot stat " << file.path.string() << std::endl;
+            return 1;
+        }
+        file.size = static_cast<uint64_t>(st.st_size);
+        file.mtime = static_cast<int64_t>(st.st_mtime);
+        files.push_back(file);
+    }
+    std::sort(files.begin(), files.end(), [](const SourceFile& a, const SourceFile& b) { return a.key < b.key; });
+    for (size_t i = 1; i < files.size(); ++i) {
+        if (files[i].key == files[i - 1].key) {
+            std::cerr << "pack_assets - Two files differ only by case: " << files[i].key << std::endl;
+            return 1;
+        }
+    }
+
+    // Chỉ mục đứng trước dữ liệu, nên tính trước offset của từng file
+    uint64_t offset = sizeof(PackHeader);
+    for (const SourceFile& file : files) {
+        offset = PackAlign(offset + sizeof(PackEntry) + file.key.size());
+    }
+    std::vector<PackEntry> entries;
+    for (const SourceFile& file : files) {
+        PackEntry entry = {};
+        entry.offset = offset;
+        entry.size = file.size;
+        entry.mtime = file.mtime;
+        entry.pathLength = static_cast<uint32_t>(file.key.size());
+        entries.push_back(entry);
+        offset = PackAlign(offset + file.size);
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "pack_assets - Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+    PackHeader header = {PACK_MAGIC, PACK_VERSION, static_cast<uint32_t>(files.size()), 0};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+    for (size_t i = 0; i < files.size(); ++i) {
+        out.write(reinterpret_cast<const char*>(&entries[i]), sizeof(PackEntry));
+        out.write(files[i].key.data(), static_cast<std::streamsize>(files[i].key.size()));
+        written += sizeof(PackEntry) + files[i].key.size();
+        writePadding(out, written, PackAlign(written));
+        written = PackAlign(written);
+    }
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::ifstream in(files[i].path, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (data.size() != entries[i].size) {
+            std::cerr << "pack_assets - Failed to read " << files[i].path.string() << std::endl;
+            return 1;
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        written += data.size();
+        writePadding(out, written, PackAlign(written));
+        written = PackAlign(written);
+    }
+    if (!out) {
+        std::cerr << "pack_assets - Write error on " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "pack_assets - Packed " << files.size() << " files (" << written / 1024 << " KB) into " << argv[2] << std::endl;
+    return 0;
+}